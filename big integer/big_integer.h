@@ -1,110 +1,1439 @@
-//
-// Created by Computer on 28.10.2019.
-//
-
-#ifndef BIG_INTEGER_H_
-#define BIG_INTEGER_H_
-
-#include <cstdint>
-#include <cmath>
-#include <vector>
-#include <ostream>
-#include <string>
-#include <algorithm>
-#include <iomanip>
-#include <map>
-#include <stdexcept>
-
-namespace big_num_arithmetic {
-
-struct DivisionByZeroError : std::exception {};
-
-class BigInteger {
- public:
-    static int internal_base;
-
-    BigInteger();
-    BigInteger(const BigInteger &other);
-    explicit BigInteger(int64_t integer);
-
-    int Sign() const;
-    void Abs();
-    void Negate();
-
-    static void SetInternalBase(int);
-
-    static BigInteger FromString(const std::string &, int base);
-    std::string ToString(int base) const;
-
-    // Compare operators
-    bool operator==(const BigInteger &) const;
-    bool operator!=(const BigInteger &) const;
-    bool operator> (const BigInteger &) const;
-    bool operator< (const BigInteger &) const;
-    bool operator>=(const BigInteger &) const;
-    bool operator<=(const BigInteger &) const;
-
-    bool operator==(int64_t) const;
-    bool operator!=(int64_t) const;
-    bool operator> (int64_t) const;
-    bool operator< (int64_t) const;
-    bool operator>=(int64_t) const;
-    bool operator<=(int64_t) const;
-
-    friend bool operator==(int64_t, const BigInteger &n);
-    friend bool operator!=(int64_t, const BigInteger &n);
-    friend bool operator> (int64_t, const BigInteger &n);
-    friend bool operator< (int64_t, const BigInteger &n);
-    friend bool operator>=(int64_t, const BigInteger &n);
-    friend bool operator<=(int64_t, const BigInteger &n);
-
-    // Arithmetic operators
-    BigInteger &operator+=(const BigInteger &);
-    BigInteger &operator-=(const BigInteger &);
-    BigInteger &operator*=(const BigInteger &);
-    BigInteger &operator/=(const BigInteger &);
-
-    BigInteger &operator+=(int64_t);
-    BigInteger &operator-=(int64_t);
-    BigInteger &operator*=(int64_t);
-    BigInteger &operator/=(int64_t);
-
-    BigInteger operator+(const BigInteger &) const;
-    BigInteger operator-(const BigInteger &) const;
-    BigInteger operator*(const BigInteger &) const;
-    BigInteger operator/(const BigInteger &) const;
-
-    BigInteger operator+(int64_t) const;
-    BigInteger operator-(int64_t) const;
-    BigInteger operator*(int64_t) const;
-    BigInteger operator/(int64_t) const;
-
-    friend BigInteger operator+(int64_t, const BigInteger &);
-    friend BigInteger operator-(int64_t, const BigInteger &);
-    friend BigInteger operator*(int64_t, const BigInteger &);
-    friend BigInteger operator/(int64_t, const BigInteger &);
-
-    BigInteger &operator++();
-    BigInteger operator++(int);
-    BigInteger &operator--();
-    BigInteger operator--(int);
-
-    uint32_t operator%(uint32_t) const;
-
-    explicit operator int64_t() const;
-
- private:
-    std::vector<int64_t> number;
-    int sign;
-
-    void RemoveLeadingNulls();
-    void ExpandNumber();
-    void ChangeSignIfNeeded();
-
-    static int GetIntValue(int, int, int);
-    static char GetCharValue(int);
-};
-
-}  // namespace big_num_arithmetic
-
-#endif  // BIG_INTEGER_H_
+//
+// Created by Computer on 28.10.2019.
+//
+
+#ifndef BIG_INTEGER_H_
+#define BIG_INTEGER_H_
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "bitwise.h"
+#include "division.h"
+#include "magnitude.h"
+#include "modular.h"
+#include "multiplication.h"
+#include "radix_conversion.h"
+#include "serialization.h"
+
+namespace big_num_arithmetic {
+
+struct DivisionByZeroError : std::exception {};
+
+// Binary limbs, carries are shifts and masks.
+constexpr int64_t kBinaryBase = int64_t(1) << 32;
+
+template<typename Limb, int64_t Base>
+class BasicBarrettReducer;
+
+template<typename Limb, int64_t Base>
+class BasicMontgomeryContext;
+
+// Sign and magnitude, the magnitude is stored in base Base limbs. The
+// base is part of the type, so numbers with different bases never mix
+// and every division by the base is a compile-time constant.
+template<typename Limb = magnitude::Limb, int64_t Base = kBinaryBase>
+class BasicBigInteger {
+    static_assert(std::is_same<Limb, magnitude::Limb>::value,
+                  "The limb kernels work on 32-bit limbs");
+    static_assert(2 <= Base && Base <= kBinaryBase,
+                  "Base must be in [2, 2^32]");
+
+ public:
+    static constexpr int64_t kBase = Base;
+
+    BasicBigInteger();
+    BasicBigInteger(const BasicBigInteger &other);
+    // Leaves other equal to zero.
+    BasicBigInteger(BasicBigInteger &&other) noexcept;
+    explicit BasicBigInteger(int64_t integer);
+
+    BasicBigInteger &operator=(const BasicBigInteger &other);
+    BasicBigInteger &operator=(BasicBigInteger &&other) noexcept;
+
+    int Sign() const;
+    void Abs();
+    void Negate();
+
+    static BasicBigInteger FromString(const std::string &, int base);
+    std::string ToString(int base) const;
+
+    // The binary format of serialization.h, the same for every Base, so
+    // for the binary base the limbs are copied as they are. The buffer
+    // overload writes SerializedSize() bytes and returns that count.
+    size_t SerializedSize() const;
+    size_t Serialize(char *buffer) const;
+    void Serialize(std::ostream &out) const;
+    // The value at the front of the input, throws std::runtime_error if
+    // it is truncated or malformed.
+    static BasicBigInteger Deserialize(const char *data, size_t size);
+    static BasicBigInteger Deserialize(std::istream &in);
+    static BasicBigInteger Deserialize(const BigIntegerView &view);
+
+    // Compare operators
+    bool operator==(const BasicBigInteger &) const;
+    bool operator!=(const BasicBigInteger &) const;
+    bool operator> (const BasicBigInteger &) const;
+    bool operator< (const BasicBigInteger &) const;
+    bool operator>=(const BasicBigInteger &) const;
+    bool operator<=(const BasicBigInteger &) const;
+
+    bool operator==(int64_t) const;
+    bool operator!=(int64_t) const;
+    bool operator> (int64_t) const;
+    bool operator< (int64_t) const;
+    bool operator>=(int64_t) const;
+    bool operator<=(int64_t) const;
+
+    friend bool operator==(int64_t lhs, const BasicBigInteger &rhs) {
+        return rhs.CompareWith(lhs) == 0;
+    }
+    friend bool operator!=(int64_t lhs, const BasicBigInteger &rhs) {
+        return rhs.CompareWith(lhs) != 0;
+    }
+    friend bool operator> (int64_t lhs, const BasicBigInteger &rhs) {
+        return rhs.CompareWith(lhs) < 0;
+    }
+    friend bool operator< (int64_t lhs, const BasicBigInteger &rhs) {
+        return rhs.CompareWith(lhs) > 0;
+    }
+    friend bool operator>=(int64_t lhs, const BasicBigInteger &rhs) {
+        return rhs.CompareWith(lhs) <= 0;
+    }
+    friend bool operator<=(int64_t lhs, const BasicBigInteger &rhs) {
+        return rhs.CompareWith(lhs) >= 0;
+    }
+
+    // Arithmetic operators
+    BasicBigInteger &operator+=(const BasicBigInteger &);
+    BasicBigInteger &operator-=(const BasicBigInteger &);
+    BasicBigInteger &operator*=(const BasicBigInteger &);
+    BasicBigInteger &operator/=(const BasicBigInteger &);
+
+    BasicBigInteger &operator+=(int64_t);
+    BasicBigInteger &operator-=(int64_t);
+    BasicBigInteger &operator*=(int64_t);
+    BasicBigInteger &operator/=(int64_t);
+
+    // The rvalue overloads reuse the storage of a temporary operand.
+    BasicBigInteger operator+(const BasicBigInteger &) const &;
+    BasicBigInteger operator-(const BasicBigInteger &) const &;
+    BasicBigInteger operator*(const BasicBigInteger &) const &;
+    BasicBigInteger operator/(const BasicBigInteger &) const &;
+
+    BasicBigInteger operator+(const BasicBigInteger &) &&;
+    BasicBigInteger operator-(const BasicBigInteger &) &&;
+    BasicBigInteger operator*(const BasicBigInteger &) &&;
+    BasicBigInteger operator/(const BasicBigInteger &) &&;
+
+    BasicBigInteger operator+(BasicBigInteger &&) const &;
+    BasicBigInteger operator-(BasicBigInteger &&) const &;
+    BasicBigInteger operator*(BasicBigInteger &&) const &;
+
+    BasicBigInteger operator+(BasicBigInteger &&) &&;
+    BasicBigInteger operator-(BasicBigInteger &&) &&;
+    BasicBigInteger operator*(BasicBigInteger &&) &&;
+
+    BasicBigInteger operator+(int64_t) const &;
+    BasicBigInteger operator-(int64_t) const &;
+    BasicBigInteger operator*(int64_t) const &;
+    BasicBigInteger operator/(int64_t) const &;
+
+    BasicBigInteger operator+(int64_t) &&;
+    BasicBigInteger operator-(int64_t) &&;
+    BasicBigInteger operator*(int64_t) &&;
+    BasicBigInteger operator/(int64_t) &&;
+
+    friend BasicBigInteger operator+(int64_t lhs, BasicBigInteger rhs) {
+        return std::move(rhs += lhs);
+    }
+    friend BasicBigInteger operator-(int64_t lhs, BasicBigInteger rhs) {
+        rhs.Negate();
+        return std::move(rhs += lhs);
+    }
+    friend BasicBigInteger operator*(int64_t lhs, BasicBigInteger rhs) {
+        return std::move(rhs *= lhs);
+    }
+    friend BasicBigInteger operator/(int64_t lhs,
+                                     const BasicBigInteger &rhs) {
+        return BasicBigInteger(lhs) /= rhs;
+    }
+
+    BasicBigInteger &operator++();
+    BasicBigInteger operator++(int);
+    BasicBigInteger &operator--();
+    BasicBigInteger operator--(int);
+
+    uint32_t operator%(uint32_t) const;
+
+    // Truncating, the remainder takes the sign of the dividend.
+    BasicBigInteger &operator%=(const BasicBigInteger &);
+    BasicBigInteger operator%(const BasicBigInteger &) const;
+
+    // Bitwise operators act on the infinite two's complement form, so
+    // ~x == -x - 1 and x >> k rounds toward minus infinity.
+    BasicBigInteger operator~() const;
+    BasicBigInteger &operator&=(const BasicBigInteger &);
+    BasicBigInteger &operator|=(const BasicBigInteger &);
+    BasicBigInteger &operator^=(const BasicBigInteger &);
+    BasicBigInteger operator&(const BasicBigInteger &) const;
+    BasicBigInteger operator|(const BasicBigInteger &) const;
+    BasicBigInteger operator^(const BasicBigInteger &) const;
+
+    BasicBigInteger &operator<<=(size_t bits);
+    BasicBigInteger &operator>>=(size_t bits);
+    BasicBigInteger operator<<(size_t bits) const;
+    BasicBigInteger operator>>(size_t bits) const;
+
+    // Bits of the two's complement form without its sign bit, and the
+    // number of them that differ from the sign bit.
+    size_t BitLength() const;
+    size_t PopCount() const;
+
+    // acc += x * y and acc -= x * y, short products are added into the
+    // limbs of acc as they are computed, without a temporary.
+    static void AddMul(BasicBigInteger &acc, const BasicBigInteger &x,
+                       const BasicBigInteger &y);
+    static void SubMul(BasicBigInteger &acc, const BasicBigInteger &x,
+                       const BasicBigInteger &y);
+    // The sum of lhs[i] * rhs[i] over i < count, the carries of all the
+    // products are propagated once.
+    static BasicBigInteger DotProduct(const BasicBigInteger *lhs,
+                                      const BasicBigInteger *rhs,
+                                      size_t count);
+
+    static BasicBigInteger Pow(BasicBigInteger base, uint64_t exponent);
+    // floor(sqrt(value)), exact tells whether value is a perfect square.
+    static BasicBigInteger ISqrt(const BasicBigInteger &value);
+    static BasicBigInteger ISqrt(const BasicBigInteger &value, bool &exact);
+    // base^exponent mod |modulus|, in [0, |modulus|).
+    static BasicBigInteger PowMod(const BasicBigInteger &base,
+                                  const BasicBigInteger &exponent,
+                                  const BasicBigInteger &modulus);
+
+    // Non-negative, Gcd(0, 0) == 0.
+    static BasicBigInteger Gcd(const BasicBigInteger &a,
+                               const BasicBigInteger &b);
+    // Gcd(a, b) == x * a + y * b.
+    static BasicBigInteger ExtendedGcd(const BasicBigInteger &a,
+                                       const BasicBigInteger &b,
+                                       BasicBigInteger &x,
+                                       BasicBigInteger &y);
+    // value^(-1) mod |modulus|, in [0, |modulus|). Throws if value and
+    // modulus are not coprime.
+    static BasicBigInteger ModInverse(const BasicBigInteger &value,
+                                      const BasicBigInteger &modulus);
+
+    explicit operator int64_t() const;
+
+ private:
+    friend class BasicBarrettReducer<Limb, Base>;
+    friend class BasicMontgomeryContext<Limb, Base>;
+
+    static constexpr magnitude::Radix kRadix{uint64_t(Base)};
+
+    magnitude::Limbs number;
+    int sign;
+
+    void RemoveLeadingNulls();
+
+    // Allocation-free paths for the int64_t overloads.
+    static uint64_t WordMagnitude(int64_t);
+    int CompareWith(int64_t) const;
+    void AddWord(int word_sign, uint64_t word);
+
+    // *this += rhs_sign * |rhs|, in place.
+    void AddSigned(const BasicBigInteger &rhs, int rhs_sign);
+
+    // *this += product_sign * |x * y|
+    void AddProduct(const BasicBigInteger &x, const BasicBigInteger &y,
+                    int product_sign);
+
+    static const BasicBigInteger &CheckDivisor(const BasicBigInteger &);
+
+    // Truncating division, the remainder takes the sign of lhs.
+    static void DivMod(const BasicBigInteger &lhs,
+                       const BasicBigInteger &rhs,
+                       BasicBigInteger &quotient,
+                       BasicBigInteger &remainder);
+
+    // lhs mod |modulus|, in [0, |modulus|).
+    static BasicBigInteger Mod(const BasicBigInteger &lhs,
+                               const BasicBigInteger &modulus);
+    static BasicBigInteger FromLimbs(magnitude::Limbs limbs);
+
+    BasicBigInteger &ApplyBitwise(bitwise::Operation op,
+                                  const BasicBigInteger &rhs);
+    // Binary words of |x| for x >= 0 and of |x| - 1 otherwise.
+    magnitude::Limbs OnesComplementWords() const;
+
+    // Trimmed binary words of |*this|, either number itself or storage.
+    const magnitude::Limbs &BinaryWords(magnitude::Limbs &storage) const;
+    static BasicBigInteger FromBinaryWords(magnitude::Limbs words,
+                                           bool negative);
+
+    static int GetIntValue(int, int, int);
+    static char GetCharValue(int);
+};
+
+using BigInteger = BasicBigInteger<>;
+
+// Divides many values by the same divisor, its reciprocal is computed
+// once on construction.
+template<typename Limb = magnitude::Limb, int64_t Base = kBinaryBase>
+class BasicBarrettReducer {
+ public:
+    using Integer = BasicBigInteger<Limb, Base>;
+
+    explicit BasicBarrettReducer(const Integer &divisor);
+
+    // Truncating division, same as operator/.
+    void DivMod(const Integer &value,
+                Integer &quotient,
+                Integer &remainder) const;
+
+    // value mod |divisor|, in [0, |divisor|).
+    Integer Reduce(const Integer &value) const;
+
+ private:
+    Integer divisor;
+    division::ReciprocalDivisor reciprocal;
+};
+
+using BarrettReducer = BasicBarrettReducer<>;
+
+// Multiplies many values modulo the same modulus without dividing, the
+// values are kept in Montgomery form x * R mod modulus. The modulus must
+// be coprime to Base, which means odd for the binary base.
+template<typename Limb = magnitude::Limb, int64_t Base = kBinaryBase>
+class BasicMontgomeryContext {
+ public:
+    using Integer = BasicBigInteger<Limb, Base>;
+
+    explicit BasicMontgomeryContext(const Integer &modulus);
+
+    // Reduces value mod |modulus| first.
+    Integer ToMontgomery(const Integer &value) const;
+    Integer FromMontgomery(const Integer &value) const;
+
+    // Both operands and the result are in Montgomery form.
+    Integer Multiply(const Integer &lhs, const Integer &rhs) const;
+    Integer Pow(const Integer &value, const Integer &exponent) const;
+
+    // |modulus|
+    const Integer &Modulus() const;
+
+ private:
+    Integer modulus;
+    modular::Montgomery montgomery;
+};
+
+using MontgomeryContext = BasicMontgomeryContext<>;
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base>::BasicBigInteger() {
+        sign = 0;
+        number.push_back(0);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base>::BasicBigInteger(int64_t integer) {
+        this->sign = (integer < 0 ? -1 : integer == 0 ? 0 : 1);
+
+        uint64_t value = WordMagnitude(integer);
+        do {
+            this->number.push_back(kRadix.Low(value));
+            value = kRadix.High(value);
+        } while (value != 0);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base>::BasicBigInteger(
+            const BasicBigInteger &other) {
+        this->sign = other.sign;
+        this->number = other.number;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base>::BasicBigInteger(
+            BasicBigInteger &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator=(
+            const BasicBigInteger &other) {
+        this->sign = other.sign;
+        this->number = other.number;
+        return *this;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator=(
+            BasicBigInteger &&other) noexcept {
+        if (this != &other) {
+            this->sign = other.sign;
+            this->number = std::move(other.number);
+            other.sign = 0;
+            other.number.push_back(0);
+        }
+        return *this;
+    }
+
+    // Public methods
+    template<typename Limb, int64_t Base>
+    int BasicBigInteger<Limb, Base>::Sign() const {
+        return (number.empty() ? 0 : sign);
+    }
+
+    template<typename Limb, int64_t Base>
+    void BasicBigInteger<Limb, Base>::Abs() {
+        sign *= sign;
+    }
+
+    template<typename Limb, int64_t Base>
+    void BasicBigInteger<Limb, Base>::Negate() {
+        sign = -sign;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::FromString(
+            const std::string &str, int base) {
+        if (base < 2 || base > 36) {
+            throw std::logic_error("Invalid base");
+        }
+
+        bool sign = (str[0] == '-');
+        int len = str.length();
+        radix_conversion::Digits digits(len - sign);
+
+        for (int i = sign; i < len; i++) {
+            digits[i - sign] = GetIntValue(str[i], base, i);
+        }
+
+        BasicBigInteger val;
+        val.number = radix_conversion::FromDigits(digits, base, kRadix);
+        val.sign = (sign ? -1 : 1);
+        val.RemoveLeadingNulls();
+
+        return val;
+    }
+
+    template<typename Limb, int64_t Base>
+    std::string BasicBigInteger<Limb, Base>::ToString(int base) const {
+        if (base < 2 || base > 36) {
+            throw std::logic_error("Invalid base");
+        }
+
+        radix_conversion::Digits digits =
+                radix_conversion::ToDigits(number, base, kRadix);
+        if (digits.empty()) {
+            return "0";
+        }
+
+        std::string ans;
+        ans.reserve(digits.size() + 1);
+        if (sign < 0) {
+            ans += '-';
+        }
+        for (uint8_t digit : digits) {
+            ans += GetCharValue(digit);
+        }
+        return ans;
+    }
+
+    // Private methods
+
+    template<typename Limb, int64_t Base>
+    void BasicBigInteger<Limb, Base>::RemoveLeadingNulls() {
+        while (!number.empty() && number.back() == 0) {
+            number.pop_back();
+        }
+
+        if (number.empty()) {
+            *this = BasicBigInteger();
+        }
+    }
+
+    template<typename Limb, int64_t Base>
+    uint64_t BasicBigInteger<Limb, Base>::WordMagnitude(int64_t integer) {
+        // Negating in uint64_t keeps INT64_MIN representable.
+        return (integer < 0 ? 0 - uint64_t(integer) : integer);
+    }
+
+    template<typename Limb, int64_t Base>
+    int BasicBigInteger<Limb, Base>::CompareWith(int64_t rhs) const {
+        int rsgn = (rhs > 0) - (rhs < 0);
+        if (sign != rsgn) {
+            return sign < rsgn ? -1 : 1;
+        }
+        if (sign == 0) {
+            return 0;
+        }
+        return magnitude::CompareWord(number, WordMagnitude(rhs), kRadix)
+               * sign;
+    }
+
+    template<typename Limb, int64_t Base>
+    void BasicBigInteger<Limb, Base>::AddWord(int word_sign, uint64_t word) {
+        if (word_sign == 0) {
+            return;
+        }
+        if (Sign() == 0) {
+            number = magnitude::FromWord(word, kRadix);
+            sign = word_sign;
+            return;
+        }
+
+        if (sign == word_sign) {
+            magnitude::AddWord(number, word, kRadix);
+            return;
+        }
+        int cmp = magnitude::CompareWord(number, word, kRadix);
+        if (cmp == 0) {
+            *this = BasicBigInteger();
+        } else if (cmp > 0) {
+            magnitude::SubWord(number, word, kRadix);
+        } else {
+            word -= magnitude::ToWord(number, kRadix);
+            number = magnitude::FromWord(word, kRadix);
+            sign = word_sign;
+        }
+    }
+
+    template<typename Limb, int64_t Base>
+    const BasicBigInteger<Limb, Base> &
+    BasicBigInteger<Limb, Base>::CheckDivisor(
+            const BasicBigInteger &divisor) {
+        if (divisor.Sign() == 0) {
+            throw DivisionByZeroError();
+        }
+        return divisor;
+    }
+
+    template<typename Limb, int64_t Base>
+    void BasicBigInteger<Limb, Base>::DivMod(const BasicBigInteger &lhs,
+                                             const BasicBigInteger &rhs,
+                                             BasicBigInteger &quotient,
+                                             BasicBigInteger &remainder) {
+        CheckDivisor(rhs);
+
+        int lsgn = lhs.sign;
+        int rsgn = rhs.sign;
+        division::DivMod(lhs.number, rhs.number, kRadix,
+                         quotient.number, remainder.number);
+
+        quotient.sign = lsgn * rsgn;
+        remainder.sign = lsgn;
+        quotient.RemoveLeadingNulls();
+        remainder.RemoveLeadingNulls();
+    }
+
+    template<typename Limb, int64_t Base>
+    int BasicBigInteger<Limb, Base>::GetIntValue(int c, int base, int i) {
+        if ('0' <= c && c <= '0' + std::min(9, base - 1)) {
+            return c - '0';
+        } else if ('a' <= c &&
+                    c <= 'a' + std::max(-1, std::min(36, base) - 11)) {
+            return c - 'a' + 10;
+        } else {
+            throw std::runtime_error("Invalid symbol at index "
+                                                  + std::to_string(i));
+        }
+    }
+
+    template<typename Limb, int64_t Base>
+    char BasicBigInteger<Limb, Base>::GetCharValue(int ost) {
+        if (0 <= ost && ost < 10) {
+            return '0' + ost;
+        } else {
+            return 'a' + ost - 10;
+        }
+    }
+
+    // Compare operators
+
+    template<typename Limb, int64_t Base>
+    bool BasicBigInteger<Limb, Base>::operator==(
+            const BasicBigInteger &rhs) const {
+        return sign == rhs.sign && number == rhs.number;
+    }
+
+    template<typename Limb, int64_t Base>
+    bool BasicBigInteger<Limb, Base>::operator>(
+            const BasicBigInteger &rhs) const {
+        if (sign != rhs.sign) {
+            return sign > rhs.sign;
+        }
+        return magnitude::Compare(number, rhs.number) * sign > 0;
+    }
+
+    template<typename Limb, int64_t Base>
+    bool BasicBigInteger<Limb, Base>::operator<(
+            const BasicBigInteger &rhs) const {
+        if (sign != rhs.sign) {
+            return sign < rhs.sign;
+        }
+        return magnitude::Compare(number, rhs.number) * sign < 0;
+    }
+
+    template<typename Limb, int64_t Base>
+    bool BasicBigInteger<Limb, Base>::operator!=(
+            const BasicBigInteger &rhs) const {
+        return !(*this == rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    bool BasicBigInteger<Limb, Base>::operator>=(
+            const BasicBigInteger &rhs) const {
+        return !(*this < rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    bool BasicBigInteger<Limb, Base>::operator<=(
+            const BasicBigInteger &rhs) const {
+        return !(*this > rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    bool BasicBigInteger<Limb, Base>::operator==(int64_t rhs) const {
+        return CompareWith(rhs) == 0;
+    }
+
+    template<typename Limb, int64_t Base>
+    bool BasicBigInteger<Limb, Base>::operator!=(int64_t rhs) const {
+        return CompareWith(rhs) != 0;
+    }
+
+    template<typename Limb, int64_t Base>
+    bool BasicBigInteger<Limb, Base>::operator<(int64_t rhs) const {
+        return CompareWith(rhs) < 0;
+    }
+
+    template<typename Limb, int64_t Base>
+    bool BasicBigInteger<Limb, Base>::operator>(int64_t rhs) const {
+        return CompareWith(rhs) > 0;
+    }
+
+    template<typename Limb, int64_t Base>
+    bool BasicBigInteger<Limb, Base>::operator>=(int64_t rhs) const {
+        return CompareWith(rhs) >= 0;
+    }
+
+    template<typename Limb, int64_t Base>
+    bool BasicBigInteger<Limb, Base>::operator<=(int64_t rhs) const {
+        return CompareWith(rhs) <= 0;
+    }
+
+    // Arithmetic operators
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator/=(
+            const BasicBigInteger &rhs) {
+        BasicBigInteger remainder;
+        DivMod(*this, rhs, *this, remainder);
+        return *this;
+    }
+
+    template<typename Limb, int64_t Base>
+    void BasicBigInteger<Limb, Base>::AddSigned(const BasicBigInteger &rhs,
+                                                int rhs_sign) {
+        if (rhs_sign == 0) {
+            return;
+        }
+        if (Sign() == 0) {
+            *this = rhs;
+            sign = rhs_sign;
+            return;
+        }
+
+        if (sign == rhs_sign) {
+            magnitude::AddShifted(number, rhs.number, 0, kRadix);
+        } else {
+            int cmp = magnitude::Compare(number, rhs.number);
+            if (cmp == 0) {
+                *this = BasicBigInteger();
+                return;
+            } else if (cmp > 0) {
+                magnitude::SubInPlace(number, rhs.number, kRadix);
+            } else {
+                magnitude::ReverseSub(number, rhs.number, kRadix);
+                sign = rhs_sign;
+            }
+        }
+        this->RemoveLeadingNulls();
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator+=(
+            const BasicBigInteger &rhs) {
+        AddSigned(rhs, rhs.sign);
+        return *this;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator*=(
+            const BasicBigInteger &rhs) {
+        if (sign == 0 || rhs.sign == 0) {
+            return (*this = BasicBigInteger());
+        }
+
+        multiplication::MultiplyInPlace(number, rhs.number, kRadix);
+        sign *= rhs.sign;
+
+        return *this;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator-=(
+            const BasicBigInteger &rhs) {
+        AddSigned(rhs, -rhs.sign);
+        return *this;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator+(
+            const BasicBigInteger &rhs) const & {
+        return BasicBigInteger(*this) += rhs;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator+(
+            const BasicBigInteger &rhs) && {
+        return std::move(*this += rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator-(
+            const BasicBigInteger &rhs) const & {
+        return BasicBigInteger(*this) -= rhs;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator-(
+            const BasicBigInteger &rhs) && {
+        return std::move(*this -= rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator/(
+            const BasicBigInteger &rhs) const & {
+        return BasicBigInteger(*this) /= rhs;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator/(
+            const BasicBigInteger &rhs) && {
+        return std::move(*this /= rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator*(
+            const BasicBigInteger &rhs) const & {
+        return BasicBigInteger(*this) *= rhs;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator*(
+            const BasicBigInteger &rhs) && {
+        return std::move(*this *= rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator+(
+            BasicBigInteger &&rhs) const & {
+        return std::move(rhs += *this);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator-(
+            BasicBigInteger &&rhs) const & {
+        rhs -= *this;
+        rhs.Negate();
+        return std::move(rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator*(
+            BasicBigInteger &&rhs) const & {
+        return std::move(rhs *= *this);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator+(
+            BasicBigInteger &&rhs) && {
+        return std::move(*this += rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator-(
+            BasicBigInteger &&rhs) && {
+        return std::move(*this -= rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator*(
+            BasicBigInteger &&rhs) && {
+        return std::move(*this *= rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator/(
+            int64_t rhs) const & {
+        return BasicBigInteger(*this) /= rhs;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator/(
+            int64_t rhs) && {
+        return std::move(*this /= rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator*(
+            int64_t rhs) const & {
+        return BasicBigInteger(*this) *= rhs;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator*(
+            int64_t rhs) && {
+        return std::move(*this *= rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator+(
+            int64_t rhs) const & {
+        return BasicBigInteger(*this) += rhs;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator+(
+            int64_t rhs) && {
+        return std::move(*this += rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator-(
+            int64_t rhs) const & {
+        return BasicBigInteger(*this) -= rhs;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator-(
+            int64_t rhs) && {
+        return std::move(*this -= rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator-=(
+            int64_t rhs) {
+        AddWord(-((rhs > 0) - (rhs < 0)), WordMagnitude(rhs));
+        return *this;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator+=(
+            int64_t rhs) {
+        AddWord((rhs > 0) - (rhs < 0), WordMagnitude(rhs));
+        return *this;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator*=(
+            int64_t rhs) {
+        if (sign == 0 || rhs == 0) {
+            return (*this = BasicBigInteger());
+        }
+
+        magnitude::MulWord(number, WordMagnitude(rhs), kRadix);
+        sign *= (rhs < 0 ? -1 : 1);
+
+        return *this;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator/=(
+            int64_t rhs) {
+        if (rhs == 0) {
+            throw DivisionByZeroError();
+        }
+
+        magnitude::DivideByWord(number, WordMagnitude(rhs), kRadix);
+        sign *= (rhs < 0 ? -1 : 1);
+        this->RemoveLeadingNulls();
+
+        return *this;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator++(int) {
+        BasicBigInteger integer(*this);
+        *this += 1;
+        return integer;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator--(int) {
+        BasicBigInteger integer(*this);
+        *this -= 1;
+        return integer;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator++() {
+        return (*this += 1);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator--() {
+        return (*this -= 1);
+    }
+
+    template<typename Limb, int64_t Base>
+    uint32_t BasicBigInteger<Limb, Base>::operator%(uint32_t rhs) const {
+        if (rhs == 0) {
+            throw DivisionByZeroError();
+        }
+
+        uint32_t rem = magnitude::ModWord(number, rhs, kRadix);
+        return (sign < 0 && rem ? rhs - rem : rem);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator%=(
+            const BasicBigInteger &rhs) {
+        BasicBigInteger quotient;
+        DivMod(*this, rhs, quotient, *this);
+        return *this;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator%(
+            const BasicBigInteger &rhs) const {
+        BasicBigInteger quotient, remainder;
+        DivMod(*this, rhs, quotient, remainder);
+        return remainder;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator~() const {
+        BasicBigInteger res(*this);
+        res.Negate();
+        return std::move(res -= 1);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator&=(
+            const BasicBigInteger &rhs) {
+        return ApplyBitwise(bitwise::Operation::kAnd, rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator|=(
+            const BasicBigInteger &rhs) {
+        return ApplyBitwise(bitwise::Operation::kOr, rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator^=(
+            const BasicBigInteger &rhs) {
+        return ApplyBitwise(bitwise::Operation::kXor, rhs);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator&(
+            const BasicBigInteger &rhs) const {
+        return BasicBigInteger(*this) &= rhs;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator|(
+            const BasicBigInteger &rhs) const {
+        return BasicBigInteger(*this) |= rhs;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator^(
+            const BasicBigInteger &rhs) const {
+        return BasicBigInteger(*this) ^= rhs;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator<<=(
+            size_t bits) {
+        if (Sign() == 0) {
+            return *this;
+        }
+        if (kRadix.IsPowerOfTwo()) {
+            bitwise::ShiftLeft(number, bits, kRadix);
+            return *this;
+        }
+        return (*this *= Pow(BasicBigInteger(2), bits));
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::operator>>=(
+            size_t bits) {
+        if (Sign() == 0) {
+            return *this;
+        }
+        if (kRadix.IsPowerOfTwo()) {
+            bool lost = bitwise::ShiftRight(number, bits, kRadix);
+            if (sign < 0 && lost) {
+                magnitude::AddWord(number, 1, kRadix);
+            }
+            RemoveLeadingNulls();
+            return *this;
+        }
+
+        BasicBigInteger remainder;
+        DivMod(*this, Pow(BasicBigInteger(2), bits), *this, remainder);
+        if (remainder.sign < 0) {
+            *this -= 1;
+        }
+        return *this;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator<<(
+            size_t bits) const {
+        return BasicBigInteger(*this) <<= bits;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::operator>>(
+            size_t bits) const {
+        return BasicBigInteger(*this) >>= bits;
+    }
+
+    template<typename Limb, int64_t Base>
+    size_t BasicBigInteger<Limb, Base>::BitLength() const {
+        return bitwise::BitLength(OnesComplementWords());
+    }
+
+    template<typename Limb, int64_t Base>
+    size_t BasicBigInteger<Limb, Base>::PopCount() const {
+        return bitwise::PopCount(OnesComplementWords());
+    }
+
+    template<typename Limb, int64_t Base>
+    void BasicBigInteger<Limb, Base>::AddProduct(const BasicBigInteger &x,
+                                                 const BasicBigInteger &y,
+                                                 int product_sign) {
+        if (product_sign == 0) {
+            return;
+        }
+        // The kernels read x and y while writing to number.
+        if (this == &x || this == &y) {
+            AddSigned(x * y, product_sign);
+            return;
+        }
+        if (Sign() == 0) {
+            number.clear();
+            sign = product_sign;
+        }
+
+        if (sign == product_sign) {
+            multiplication::AddMul(number, x.number, y.number, kRadix);
+        } else if (multiplication::SubMul(number, x.number, y.number,
+                                          kRadix)) {
+            sign = product_sign;
+        }
+        RemoveLeadingNulls();
+    }
+
+    template<typename Limb, int64_t Base>
+    void BasicBigInteger<Limb, Base>::AddMul(BasicBigInteger &acc,
+                                             const BasicBigInteger &x,
+                                             const BasicBigInteger &y) {
+        acc.AddProduct(x, y, x.Sign() * y.Sign());
+    }
+
+    template<typename Limb, int64_t Base>
+    void BasicBigInteger<Limb, Base>::SubMul(BasicBigInteger &acc,
+                                             const BasicBigInteger &x,
+                                             const BasicBigInteger &y) {
+        acc.AddProduct(x, y, -x.Sign() * y.Sign());
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::DotProduct(
+            const BasicBigInteger *lhs, const BasicBigInteger *rhs,
+            size_t count) {
+        multiplication::ProductSum sum(kRadix);
+        for (size_t i = 0; i < count; i++) {
+            sum.Add(lhs[i].number, rhs[i].number,
+                    lhs[i].Sign() * rhs[i].Sign());
+        }
+        int sum_sign;
+        BasicBigInteger res = FromLimbs(sum.Finish(sum_sign));
+        if (sum_sign < 0) {
+            res.Negate();
+        }
+        return res;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::Pow(
+            BasicBigInteger base, uint64_t exponent) {
+        BasicBigInteger res(1);
+        while (exponent) {
+            if (exponent & 1) {
+                res *= base;
+            }
+            exponent >>= 1;
+            if (exponent) {
+                base *= base;
+            }
+        }
+        return res;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::ISqrt(
+            const BasicBigInteger &value) {
+        bool exact;
+        return ISqrt(value, exact);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::ISqrt(
+            const BasicBigInteger &value, bool &exact) {
+        if (value.sign < 0) {
+            throw std::runtime_error("Square root of a negative number");
+        }
+        return FromLimbs(division::ISqrt(value.number, kRadix, exact));
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::PowMod(
+            const BasicBigInteger &base,
+            const BasicBigInteger &exponent,
+            const BasicBigInteger &modulus) {
+        if (exponent.sign < 0) {
+            throw std::logic_error("Negative exponent");
+        }
+        BasicBigInteger value = Mod(base, modulus);
+        if (modulus == 1 || modulus == -1) {
+            return BasicBigInteger();
+        }
+
+        modular::Bits bits = modular::ToBits(exponent.number, kRadix);
+        if (std::gcd(uint64_t(modulus.number[0]), uint64_t(Base)) == 1) {
+            modular::Montgomery montgomery(modulus.number, kRadix);
+            magnitude::Limbs res = montgomery.Pow(
+                    montgomery.ToMontgomery(value.number), bits);
+            return FromLimbs(montgomery.FromMontgomery(res));
+        }
+
+        // Moduli sharing a factor with the base reduce every product
+        // with a precomputed reciprocal instead.
+        division::ReciprocalDivisor reciprocal(modulus.number, kRadix);
+        auto multiply = [&reciprocal](const magnitude::Limbs &lhs,
+                                      const magnitude::Limbs &rhs) {
+            magnitude::Limbs quotient, remainder;
+            reciprocal.DivMod(multiplication::Multiply(lhs, rhs, kRadix),
+                              quotient, remainder);
+            return remainder;
+        };
+        return FromLimbs(modular::SlidingWindowPow(value.number, bits,
+                                                   magnitude::Limbs{1},
+                                                   multiply));
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::Gcd(
+            const BasicBigInteger &a, const BasicBigInteger &b) {
+        magnitude::Limbs res = modular::Gcd(
+                bitwise::ToBinary(a.number, kRadix),
+                bitwise::ToBinary(b.number, kRadix));
+        return FromLimbs(bitwise::FromBinary(res, kRadix));
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::ExtendedGcd(
+            const BasicBigInteger &a, const BasicBigInteger &b,
+            BasicBigInteger &x, BasicBigInteger &y) {
+        BasicBigInteger first(a), second(b);
+        first.Abs();
+        second.Abs();
+        bool swapped = (first < second);
+        if (swapped) {
+            std::swap(first, second);
+        }
+
+        // r0 = s0 * first and r1 = s1 * first modulo second, the steps
+        // of Lehmer's matrices apply to the cofactors as well.
+        magnitude::Limbs r0 = bitwise::ToBinary(first.number, kRadix);
+        magnitude::Limbs r1 = bitwise::ToBinary(second.number, kRadix);
+        BasicBigInteger s0(1), s1(0);
+        magnitude::Limbs quotient;
+        while (!r1.empty()) {
+            modular::LehmerMatrix m;
+            if (modular::LehmerStep(r0, r1, m)) {
+                modular::ApplyLehmer(r0, r1, m);
+                BasicBigInteger s = s0 * m.a + s1 * m.b;
+                s1 = s0 * m.c + s1 * m.d;
+                s0 = std::move(s);
+            } else {
+                modular::EuclidStep(r0, r1, quotient);
+                s0 -= FromLimbs(bitwise::FromBinary(quotient, kRadix)) * s1;
+                std::swap(s0, s1);
+            }
+        }
+
+        BasicBigInteger gcd = FromLimbs(bitwise::FromBinary(r0, kRadix));
+        BasicBigInteger t;
+        if (second.Sign() != 0) {
+            t = (gcd - s0 * first) / second;
+        } else {
+            s0 = BasicBigInteger(gcd.Sign());
+        }
+        if (swapped) {
+            std::swap(s0, t);
+        }
+        x = s0 * a.Sign();
+        y = t * b.Sign();
+        return gcd;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::ModInverse(
+            const BasicBigInteger &value, const BasicBigInteger &modulus) {
+        BasicBigInteger reduced = Mod(value, modulus);
+        BasicBigInteger x, y;
+        if (ExtendedGcd(reduced, modulus, x, y) != 1) {
+            throw std::logic_error("No modular inverse");
+        }
+        return Mod(x, modulus);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::Mod(
+            const BasicBigInteger &lhs, const BasicBigInteger &modulus) {
+        BasicBigInteger remainder = lhs % modulus;
+        if (remainder.sign < 0) {
+            remainder.AddSigned(modulus, 1);
+        }
+        return remainder;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::FromLimbs(
+            magnitude::Limbs limbs) {
+        BasicBigInteger res;
+        res.number = std::move(limbs);
+        res.sign = 1;
+        res.RemoveLeadingNulls();
+        return res;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> &BasicBigInteger<Limb, Base>::ApplyBitwise(
+            bitwise::Operation op, const BasicBigInteger &rhs) {
+        magnitude::Limbs words;
+        bool negative;
+        bitwise::Apply(op, bitwise::ToBinary(number, kRadix), sign < 0,
+                       bitwise::ToBinary(rhs.number, kRadix), rhs.sign < 0,
+                       words, negative);
+        number = bitwise::FromBinary(words, kRadix);
+        sign = (negative ? -1 : 1);
+        RemoveLeadingNulls();
+        return *this;
+    }
+
+    template<typename Limb, int64_t Base>
+    magnitude::Limbs BasicBigInteger<Limb, Base>::OnesComplementWords() const {
+        magnitude::Limbs words = bitwise::ToBinary(number, kRadix);
+        if (sign < 0) {
+            magnitude::SubWord(words, 1, magnitude::Radix(kBinaryBase));
+            magnitude::Trim(words);
+        }
+        return words;
+    }
+
+    template<typename Limb, int64_t Base>
+    const magnitude::Limbs &BasicBigInteger<Limb, Base>::BinaryWords(
+            magnitude::Limbs &storage) const {
+        if (Sign() == 0) {
+            return storage;
+        }
+        if (Base == kBinaryBase) {
+            return number;
+        }
+        storage = bitwise::ToBinary(number, kRadix);
+        return storage;
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::FromBinaryWords(
+            magnitude::Limbs words, bool negative) {
+        if (Base != kBinaryBase) {
+            words = bitwise::FromBinary(words, kRadix);
+        }
+        BasicBigInteger res = FromLimbs(std::move(words));
+        if (negative) {
+            res.Negate();
+        }
+        return res;
+    }
+
+    template<typename Limb, int64_t Base>
+    size_t BasicBigInteger<Limb, Base>::SerializedSize() const {
+        magnitude::Limbs storage;
+        return serialization::ByteSize(BinaryWords(storage).size());
+    }
+
+    template<typename Limb, int64_t Base>
+    size_t BasicBigInteger<Limb, Base>::Serialize(char *buffer) const {
+        magnitude::Limbs storage;
+        return serialization::Write(BinaryWords(storage), sign < 0, buffer);
+    }
+
+    template<typename Limb, int64_t Base>
+    void BasicBigInteger<Limb, Base>::Serialize(std::ostream &out) const {
+        magnitude::Limbs storage;
+        serialization::Write(BinaryWords(storage), sign < 0, out);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::Deserialize(
+            const char *data, size_t size) {
+        return Deserialize(BigIntegerView::Parse(data, size));
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::Deserialize(
+            std::istream &in) {
+        bool negative;
+        magnitude::Limbs words = serialization::Read(in, negative);
+        return FromBinaryWords(std::move(words), negative);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base> BasicBigInteger<Limb, Base>::Deserialize(
+            const BigIntegerView &view) {
+        return FromBinaryWords(view.Words(), view.Sign() < 0);
+    }
+
+    template<typename Limb, int64_t Base>
+    BasicBigInteger<Limb, Base>::operator int64_t() const {
+        if (*this > std::numeric_limits<int64_t>::max() ||
+            *this < std::numeric_limits<int64_t>::min()) {
+            throw std::runtime_error("int64_t overflow");
+        }
+
+        uint64_t val = 0;
+        int sz = this->number.size();
+
+        for (int i = sz - 1; i >= 0; i--) {
+            val *= uint64_t(Base);
+            val += (this->number[i]);
+        }
+
+        return int64_t(this->sign < 0 ? 0 - val : val);
+    }
+
+    // BasicBarrettReducer
+
+    template<typename Limb, int64_t Base>
+    BasicBarrettReducer<Limb, Base>::BasicBarrettReducer(
+            const Integer &divisor)
+            : divisor(Integer::CheckDivisor(divisor)),
+              reciprocal(divisor.number, Integer::kRadix) {}
+
+    template<typename Limb, int64_t Base>
+    void BasicBarrettReducer<Limb, Base>::DivMod(const Integer &value,
+                                                 Integer &quotient,
+                                                 Integer &remainder) const {
+        int lsgn = value.sign;
+        reciprocal.DivMod(value.number, quotient.number, remainder.number);
+
+        quotient.sign = lsgn * divisor.sign;
+        remainder.sign = lsgn;
+        quotient.RemoveLeadingNulls();
+        remainder.RemoveLeadingNulls();
+    }
+
+    template<typename Limb, int64_t Base>
+    typename BasicBarrettReducer<Limb, Base>::Integer
+    BasicBarrettReducer<Limb, Base>::Reduce(const Integer &value) const {
+        Integer quotient, remainder;
+        DivMod(value, quotient, remainder);
+
+        if (remainder.Sign() < 0) {
+            Integer modulus(divisor);
+            modulus.Abs();
+            remainder += modulus;
+        }
+        return remainder;
+    }
+
+    // BasicMontgomeryContext
+
+    template<typename Limb, int64_t Base>
+    BasicMontgomeryContext<Limb, Base>::BasicMontgomeryContext(
+            const Integer &modulus)
+            : modulus(Integer::CheckDivisor(modulus)),
+              montgomery(modulus.number, Integer::kRadix) {
+        this->modulus.Abs();
+    }
+
+    template<typename Limb, int64_t Base>
+    typename BasicMontgomeryContext<Limb, Base>::Integer
+    BasicMontgomeryContext<Limb, Base>::ToMontgomery(
+            const Integer &value) const {
+        Integer reduced = Integer::Mod(value, modulus);
+        return Integer::FromLimbs(montgomery.ToMontgomery(reduced.number));
+    }
+
+    template<typename Limb, int64_t Base>
+    typename BasicMontgomeryContext<Limb, Base>::Integer
+    BasicMontgomeryContext<Limb, Base>::FromMontgomery(
+            const Integer &value) const {
+        return Integer::FromLimbs(montgomery.FromMontgomery(value.number));
+    }
+
+    template<typename Limb, int64_t Base>
+    typename BasicMontgomeryContext<Limb, Base>::Integer
+    BasicMontgomeryContext<Limb, Base>::Multiply(const Integer &lhs,
+                                                 const Integer &rhs) const {
+        return Integer::FromLimbs(montgomery.Multiply(lhs.number, rhs.number));
+    }
+
+    template<typename Limb, int64_t Base>
+    typename BasicMontgomeryContext<Limb, Base>::Integer
+    BasicMontgomeryContext<Limb, Base>::Pow(const Integer &value,
+                                            const Integer &exponent) const {
+        if (exponent.Sign() < 0) {
+            throw std::logic_error("Negative exponent");
+        }
+        modular::Bits bits = modular::ToBits(exponent.number, Integer::kRadix);
+        return Integer::FromLimbs(montgomery.Pow(value.number, bits));
+    }
+
+    template<typename Limb, int64_t Base>
+    const typename BasicMontgomeryContext<Limb, Base>::Integer &
+    BasicMontgomeryContext<Limb, Base>::Modulus() const {
+        return modulus;
+    }
+
+extern template class BasicBigInteger<>;
+extern template class BasicBarrettReducer<>;
+extern template class BasicMontgomeryContext<>;
+
+}  // namespace big_num_arithmetic
+
+#endif  // BIG_INTEGER_H_
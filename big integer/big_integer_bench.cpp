@@ -0,0 +1,267 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "big_integer.h"
+#include "fixed_integer.h"
+
+using big_num_arithmetic::BigInteger;
+
+namespace {
+
+// A positive number of exactly limbs binary limbs.
+BigInteger GenInteger(int64_t limbs, uint32_t seed) {
+    std::mt19937 mt(seed);
+    std::uniform_int_distribution<int> dist(0, 15);
+    std::string hex(8 * limbs, '0');
+    for (auto &c : hex) {
+        c = "0123456789abcdef"[dist(mt)];
+    }
+    hex[0] = '8';
+    return BigInteger::FromString(hex, 16);
+}
+
+// Operand sizes in limbs: 1, 10, ..., 10^6.
+void Sizes(benchmark::internal::Benchmark *bench) {
+    bench->RangeMultiplier(10)->Range(1, 1'000'000)
+         ->Unit(benchmark::kMicrosecond);
+}
+
+void SetLimbsProcessed(benchmark::State &state) {
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Add(benchmark::State &state) {
+    BigInteger a = GenInteger(state.range(0), 1);
+    BigInteger b = GenInteger(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a + b);
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_Add)->Apply(Sizes);
+
+void BM_Sub(benchmark::State &state) {
+    BigInteger a = GenInteger(state.range(0), 1);
+    BigInteger b = GenInteger(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a - b);
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_Sub)->Apply(Sizes);
+
+void BM_Mul(benchmark::State &state) {
+    BigInteger a = GenInteger(state.range(0), 1);
+    BigInteger b = GenInteger(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a * b);
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_Mul)->Apply(Sizes);
+
+// acc += x * y, fused and through a temporary product.
+void BM_AddMul(benchmark::State &state) {
+    BigInteger acc = GenInteger(2 * state.range(0), 1);
+    BigInteger x = GenInteger(state.range(0), 2);
+    BigInteger y = GenInteger(state.range(0), 3);
+    for (auto _ : state) {
+        BigInteger::AddMul(acc, x, y);
+        BigInteger::SubMul(acc, x, y);
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_AddMul)->Apply(Sizes);
+
+void BM_AddProduct(benchmark::State &state) {
+    BigInteger acc = GenInteger(2 * state.range(0), 1);
+    BigInteger x = GenInteger(state.range(0), 2);
+    BigInteger y = GenInteger(state.range(0), 3);
+    for (auto _ : state) {
+        acc += x * y;
+        acc -= x * y;
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_AddProduct)->Apply(Sizes);
+
+// 64 pairs of n-limb operands.
+void BM_DotProduct(benchmark::State &state) {
+    std::vector<BigInteger> lhs, rhs;
+    for (uint32_t i = 0; i < 64; i++) {
+        lhs.push_back(GenInteger(state.range(0), 2 * i));
+        rhs.push_back(GenInteger(state.range(0), 2 * i + 1) * -1);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+                BigInteger::DotProduct(lhs.data(), rhs.data(), 64));
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_DotProduct)->RangeMultiplier(10)->Range(1, 1'000)
+                         ->Unit(benchmark::kMicrosecond);
+
+void BM_DotProductNaive(benchmark::State &state) {
+    std::vector<BigInteger> lhs, rhs;
+    for (uint32_t i = 0; i < 64; i++) {
+        lhs.push_back(GenInteger(state.range(0), 2 * i));
+        rhs.push_back(GenInteger(state.range(0), 2 * i + 1) * -1);
+    }
+    for (auto _ : state) {
+        BigInteger sum(0);
+        for (size_t i = 0; i < 64; i++) {
+            sum += lhs[i] * rhs[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_DotProductNaive)->RangeMultiplier(10)->Range(1, 1'000)
+                              ->Unit(benchmark::kMicrosecond);
+
+// A 2n-limb dividend by an n-limb divisor.
+void BM_Div(benchmark::State &state) {
+    BigInteger a = GenInteger(2 * state.range(0), 1);
+    BigInteger b = GenInteger(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a / b);
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_Div)->Apply(Sizes);
+
+void BM_Mod(benchmark::State &state) {
+    BigInteger a = GenInteger(2 * state.range(0), 1);
+    BigInteger b = GenInteger(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a % b);
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_Mod)->Apply(Sizes);
+
+// Equal but for the lowest limb, so every limb is compared.
+void BM_Compare(benchmark::State &state) {
+    BigInteger a = GenInteger(state.range(0), 1);
+    BigInteger b = a + BigInteger(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a < b);
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_Compare)->Apply(Sizes);
+
+void BM_ToString(benchmark::State &state) {
+    BigInteger a = GenInteger(state.range(0), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.ToString(10));
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_ToString)->Apply(Sizes);
+
+void BM_FromString(benchmark::State &state) {
+    std::string str = GenInteger(state.range(0), 1).ToString(10);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(BigInteger::FromString(str, 10));
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_FromString)->Apply(Sizes);
+
+void BM_Serialize(benchmark::State &state) {
+    BigInteger a = GenInteger(state.range(0), 1);
+    std::string buffer(a.SerializedSize(), '\0');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.Serialize(&buffer[0]));
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_Serialize)->Apply(Sizes);
+
+void BM_Deserialize(benchmark::State &state) {
+    BigInteger a = GenInteger(state.range(0), 1);
+    std::string buffer(a.SerializedSize(), '\0');
+    a.Serialize(&buffer[0]);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+                BigInteger::Deserialize(buffer.data(), buffer.size()));
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_Deserialize)->Apply(Sizes);
+
+// The root of a 2n-limb number.
+void BM_Sqrt(benchmark::State &state) {
+    BigInteger a = GenInteger(2 * state.range(0), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(BigInteger::ISqrt(a));
+    }
+    SetLimbsProcessed(state);
+}
+BENCHMARK(BM_Sqrt)->Apply(Sizes);
+
+// The same products and quotients on Bits-wide fixed integers, compare
+// with BM_Mul and BM_Div at Bits / 32 limbs.
+template<size_t Bits>
+void BM_FixedMul(benchmark::State &state) {
+    big_num_arithmetic::FixedInteger<Bits> a(GenInteger(Bits / 64, 1));
+    big_num_arithmetic::FixedInteger<Bits> b(GenInteger(Bits / 64, 2));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a * b);
+    }
+}
+BENCHMARK_TEMPLATE(BM_FixedMul, 128);
+BENCHMARK_TEMPLATE(BM_FixedMul, 256);
+BENCHMARK_TEMPLATE(BM_FixedMul, 4096);
+
+template<size_t Bits>
+void BM_FixedDiv(benchmark::State &state) {
+    big_num_arithmetic::FixedInteger<Bits> a(GenInteger(Bits / 32 - 1, 1));
+    big_num_arithmetic::FixedInteger<Bits> b(GenInteger(Bits / 64, 2));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a / b);
+    }
+}
+BENCHMARK_TEMPLATE(BM_FixedDiv, 128);
+BENCHMARK_TEMPLATE(BM_FixedDiv, 256);
+BENCHMARK_TEMPLATE(BM_FixedDiv, 4096);
+
+}  // namespace
+
+// Unless --benchmark_out is given, results also go to
+// big_integer_bench.json, as JSON unless --benchmark_out_format names
+// another format, so runs can be compared with tools/compare.py.
+int main(int argc, char **argv) {
+    std::vector<char *> args(argv, argv + argc);
+    std::string out = "--benchmark_out=big_integer_bench.json";
+    std::string format = "--benchmark_out_format=json";
+    bool has_out = false;
+    bool has_format = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        has_out |= (arg.rfind("--benchmark_out=", 0) == 0);
+        has_format |= (arg.rfind("--benchmark_out_format=", 0) == 0);
+    }
+    if (!has_out) {
+        args.push_back(&out[0]);
+        if (!has_format) {
+            args.push_back(&format[0]);
+        }
+    }
+    // Like argv, the arguments end with a null pointer.
+    int count = args.size();
+    args.push_back(nullptr);
+
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -1,174 +1,1186 @@
-//
-// Created by ZenBook on 04.11.2019.
-//
-
-#include <random>
-#include "big_integer.h"
-#include "gtest.h"
-
-std::vector<int64_t> GenData(int size) {
-    std::vector<int64_t> data(size);
-    std::random_device rd;
-    std::mt19937 mt(rd());
-
-    std::uniform_int_distribution<int64_t> dist(INT32_MIN, INT32_MAX);
-
-    for (auto &x : data) {
-        x = dist(mt);
-    }
-    data.push_back(0);
-
-    return data;
-}
-
-namespace big_num_arithmetic {
-    int Sign(int64_t v) {
-        return (v > 0 ? 1 : v < 0 ? -1 : 0);
-    }
-
-    TEST(BigIntegerTests, Sign) {
-        std::vector<int64_t> v = GenData(1'000);
-
-        for (auto x : v) {
-            if (x > 0) {
-                EXPECT_EQ(BigInteger(x).Sign(), 1);
-            } else if (x < 0) {
-                EXPECT_EQ(BigInteger(x).Sign(), -1);
-            } else {
-                EXPECT_EQ(BigInteger(x).Sign(), 0);
-            }
-        }
-    }
-
-    TEST(BigIntegerTests, Abs) {
-        std::vector<int64_t> v = GenData(1'000);
-
-        for (auto x : v) {
-            BigInteger val = BigInteger(x);
-            val.Abs();
-            if (x != 0) {
-                EXPECT_EQ(val.Sign(), 1);
-            } else {
-                EXPECT_EQ(val.Sign(), 0);
-            }
-        }
-    }
-
-    TEST(BigIntegerTests, Negate) {
-        std::vector<int64_t> v = GenData(1'000);
-
-        for (auto x : v) {
-            BigInteger val(x);
-            val.Negate();
-            if (x > 0) {
-                EXPECT_EQ(val.Sign(), -1);
-            } else if (x < 0) {
-                EXPECT_EQ(val.Sign(), 1);
-            } else {
-                EXPECT_EQ(val.Sign(), 0);
-            }
-        }
-    }
-
-    TEST(BigIntegerTests, ComparisonOperators) {
-        std::vector<int64_t> v = GenData(1'000);
-
-        for (auto x  : v) {
-            for (auto y : v) {
-                BigInteger bx(x);
-                BigInteger by(y);
-
-                EXPECT_EQ(bx == by, x == y);
-                EXPECT_EQ(bx != by, x != y);
-                EXPECT_EQ(bx >= by, x >= y);
-                EXPECT_EQ(bx <= by, x <= y);
-                EXPECT_EQ(bx > by, x > y);
-                EXPECT_EQ(bx < by, x < y);
-            }
-        }
-    }
-
-    TEST(BigIntegerTests, BinaryOperators) {
-        std::vector<int64_t> v = GenData(1'000);
-
-        for (auto x : v) {
-            for (auto y : v) {
-                BigInteger bx(x), by(y);
-
-                BigInteger b_plus = bx + by;
-                int64_t c_plus = x + y;
-                EXPECT_EQ(b_plus, c_plus);
-                EXPECT_EQ(b_plus.Sign(), Sign(c_plus));
-
-                BigInteger b_minus = bx - by;
-                int64_t c_minus = x - y;
-                EXPECT_EQ(b_minus, c_minus);
-                EXPECT_EQ(b_minus.Sign(), Sign(c_minus));
-
-                BigInteger b_mult = bx * by;
-                int64_t c_mult = x * y;
-                EXPECT_EQ(b_mult, c_mult);
-                EXPECT_EQ(b_mult.Sign(), Sign(c_mult));
-
-                if (!y) {
-                    std::swap(x, y);
-                    std::swap(bx, by);
-                }
-                BigInteger b_div = bx / by;
-                int64_t c_div = x / y;
-                EXPECT_EQ(b_div, c_div);
-                EXPECT_EQ(b_div.Sign(), Sign(c_div));
-            }
-        }
-    }
-
-    TEST(BigIntegerTests, Modulo) {
-        std::vector<int64_t> v = {17, -1, 25, 11, 12, 23, 42, 2, -23424};
-
-        for (auto x : v) {
-            x = std::abs(x);
-            for (auto y : v) {
-                y = std::abs(y);
-                BigInteger bx(x);
-
-                EXPECT_EQ(bx % y, x % y);
-            }
-        }
-    }
-
-    TEST(BigIntegerTests, FromString) {
-        BigInteger bi = BigInteger::FromString("-0000009", 11);
-
-        EXPECT_EQ(bi, -9);
-
-        bi = BigInteger::FromString("-0000000000900001", 10);
-
-        EXPECT_EQ(bi, -900001);
-    }
-
-    TEST(BigIntegerTests, ToString) {
-        BigInteger::SetInternalBase(2);
-        BigInteger bi = BigInteger::FromString("-1111111", 2);
-        std::string str = bi.ToString(3);
-        std::cout << str << std::endl;
-    }
-
-    TEST(BigIntegerTests, UnaryOperators) {
-        std::vector<int64_t> v = GenData(1000);
-
-        for (auto x : v) {
-            BigInteger bx(x);
-
-            ++bx;
-            ++x;
-            EXPECT_EQ(bx, x);
-            bx++;
-            x++;
-            EXPECT_EQ(bx, x);
-            --bx, --x;
-            EXPECT_EQ(bx, x);
-            bx--, x--;
-            EXPECT_EQ(bx, x);
-        }
-    }
-}  // namespace big_num_arithmetic
+//
+// Created by ZenBook on 04.11.2019.
+//
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <memory_resource>
+#include <random>
+#include <sstream>
+#include <thread>
+#include "big_integer.h"
+#include "division.h"
+#include "fixed_integer.h"
+#include "mapped_file.h"
+#include "multiplication.h"
+#include "simd.h"
+#include "small_vector.h"
+#include "thread_pool.h"
+#include "gtest.h"
+
+std::vector<int64_t> GenData(int size) {
+    std::vector<int64_t> data(size);
+    std::random_device rd;
+    std::mt19937 mt(rd());
+
+    std::uniform_int_distribution<int64_t> dist(INT32_MIN, INT32_MAX);
+
+    for (auto &x : data) {
+        x = dist(mt);
+    }
+    data.push_back(0);
+
+    return data;
+}
+
+namespace big_num_arithmetic {
+    int Sign(int64_t v) {
+        return (v > 0 ? 1 : v < 0 ? -1 : 0);
+    }
+
+    TEST(BigIntegerTests, Sign) {
+        std::vector<int64_t> v = GenData(1'000);
+
+        for (auto x : v) {
+            if (x > 0) {
+                EXPECT_EQ(BigInteger(x).Sign(), 1);
+            } else if (x < 0) {
+                EXPECT_EQ(BigInteger(x).Sign(), -1);
+            } else {
+                EXPECT_EQ(BigInteger(x).Sign(), 0);
+            }
+        }
+    }
+
+    TEST(BigIntegerTests, Abs) {
+        std::vector<int64_t> v = GenData(1'000);
+
+        for (auto x : v) {
+            BigInteger val = BigInteger(x);
+            val.Abs();
+            if (x != 0) {
+                EXPECT_EQ(val.Sign(), 1);
+            } else {
+                EXPECT_EQ(val.Sign(), 0);
+            }
+        }
+    }
+
+    TEST(BigIntegerTests, Negate) {
+        std::vector<int64_t> v = GenData(1'000);
+
+        for (auto x : v) {
+            BigInteger val(x);
+            val.Negate();
+            if (x > 0) {
+                EXPECT_EQ(val.Sign(), -1);
+            } else if (x < 0) {
+                EXPECT_EQ(val.Sign(), 1);
+            } else {
+                EXPECT_EQ(val.Sign(), 0);
+            }
+        }
+    }
+
+    TEST(BigIntegerTests, ComparisonOperators) {
+        std::vector<int64_t> v = GenData(1'000);
+
+        for (auto x  : v) {
+            for (auto y : v) {
+                BigInteger bx(x);
+                BigInteger by(y);
+
+                EXPECT_EQ(bx == by, x == y);
+                EXPECT_EQ(bx != by, x != y);
+                EXPECT_EQ(bx >= by, x >= y);
+                EXPECT_EQ(bx <= by, x <= y);
+                EXPECT_EQ(bx > by, x > y);
+                EXPECT_EQ(bx < by, x < y);
+            }
+        }
+    }
+
+    TEST(BigIntegerTests, BinaryOperators) {
+        std::vector<int64_t> v = GenData(1'000);
+
+        for (auto x : v) {
+            for (auto y : v) {
+                BigInteger bx(x), by(y);
+
+                BigInteger b_plus = bx + by;
+                int64_t c_plus = x + y;
+                EXPECT_EQ(b_plus, c_plus);
+                EXPECT_EQ(b_plus.Sign(), Sign(c_plus));
+
+                BigInteger b_minus = bx - by;
+                int64_t c_minus = x - y;
+                EXPECT_EQ(b_minus, c_minus);
+                EXPECT_EQ(b_minus.Sign(), Sign(c_minus));
+
+                BigInteger b_mult = bx * by;
+                int64_t c_mult = x * y;
+                EXPECT_EQ(b_mult, c_mult);
+                EXPECT_EQ(b_mult.Sign(), Sign(c_mult));
+
+                if (!y) {
+                    std::swap(x, y);
+                    std::swap(bx, by);
+                }
+                BigInteger b_div = bx / by;
+                int64_t c_div = x / y;
+                EXPECT_EQ(b_div, c_div);
+                EXPECT_EQ(b_div.Sign(), Sign(c_div));
+            }
+        }
+    }
+
+    TEST(BigIntegerTests, Modulo) {
+        std::vector<int64_t> v = {17, -1, 25, 11, 12, 23, 42, 2, -23424};
+
+        for (auto x : v) {
+            x = std::abs(x);
+            for (auto y : v) {
+                y = std::abs(y);
+                BigInteger bx(x);
+
+                EXPECT_EQ(bx % y, x % y);
+            }
+        }
+    }
+
+    TEST(BigIntegerTests, FromString) {
+        BigInteger bi = BigInteger::FromString("-0000009", 11);
+
+        EXPECT_EQ(bi, -9);
+
+        bi = BigInteger::FromString("-0000000000900001", 10);
+
+        EXPECT_EQ(bi, -900001);
+    }
+
+    TEST(BigIntegerTests, ToString) {
+        using BinaryDigits = BasicBigInteger<magnitude::Limb, 2>;
+        BinaryDigits bi = BinaryDigits::FromString("-1111111", 2);
+        std::string str = bi.ToString(3);
+        std::cout << str << std::endl;
+    }
+
+    template<typename Integer>
+    void CheckRadixConversion() {
+        std::mt19937 mt(17);
+        std::uniform_int_distribution<int> dist(0, 35);
+
+        for (int radix : {2, 3, 10, 16, 36}) {
+            for (int len : {1, 10, 700, 4'000}) {
+                std::string str = "-";
+                for (int i = 0; i < len; i++) {
+                    str += "0123456789abcdefghijklmnopqrstuvwxyz"
+                            [dist(mt) % radix];
+                }
+                str[1] = (str[1] == '0' ? '1' : str[1]);
+
+                Integer bi = Integer::FromString(str, radix);
+                EXPECT_EQ(bi.ToString(radix), str);
+            }
+        }
+    }
+
+    TEST(BigIntegerTests, LargeRadixConversion) {
+        CheckRadixConversion<BasicBigInteger<magnitude::Limb, 2>>();
+        CheckRadixConversion<BasicBigInteger<magnitude::Limb, 10>>();
+        CheckRadixConversion<BasicBigInteger<magnitude::Limb, 10'000>>();
+        CheckRadixConversion<BasicBigInteger<magnitude::Limb, INT32_MAX>>();
+        CheckRadixConversion<BigInteger>();
+
+        BigInteger power(1);
+        for (int i = 0; i < 6'000; i++) {
+            power *= 3;
+        }
+        EXPECT_EQ(power.ToString(3), "1" + std::string(6'000, '0'));
+        EXPECT_EQ(BigInteger::FromString(power.ToString(10), 10), power);
+        EXPECT_EQ(BigInteger::FromString(power.ToString(7), 7), power);
+    }
+
+    TEST(BigIntegerTests, CompileTimeBase) {
+        using Decimal = BasicBigInteger<magnitude::Limb, 10>;
+        static_assert(Decimal::kBase == 10, "");
+        static_assert(BigInteger::kBase == kBinaryBase, "");
+
+        std::vector<int64_t> v = GenData(100);
+        for (int64_t x : v) {
+            for (int64_t y : v) {
+                Decimal dx(x), dy(y);
+                EXPECT_EQ(int64_t(dx * dy), x * y);
+                EXPECT_EQ(int64_t(dx - dy), x - y);
+                EXPECT_EQ((dx * dy).ToString(16),
+                          (BigInteger(x) * BigInteger(y)).ToString(16));
+            }
+        }
+    }
+
+    template<typename Integer>
+    void CheckWordOperators() {
+        std::vector<int64_t> words = {0, 1, -1, 7, -13, int64_t{1} << 40,
+                                      INT32_MIN, INT64_MAX, INT64_MIN};
+        std::vector<int64_t> v = GenData(50);
+        v.insert(v.end(), words.begin(), words.end());
+
+        for (int64_t x : v) {
+            Integer bx = Integer(x) * Integer(x) * (x % 3 ? 1 : -1);
+            for (int64_t y : words) {
+                Integer by(y);
+                EXPECT_EQ(bx + y, bx + by);
+                EXPECT_EQ(bx - y, bx - by);
+                EXPECT_EQ(y - bx, by - bx);
+                EXPECT_EQ(bx * y, bx * by);
+                EXPECT_EQ(y * bx, by * bx);
+                if (y != 0) {
+                    EXPECT_EQ(bx / y, bx / by);
+                }
+
+                EXPECT_EQ(bx == y, bx == by);
+                EXPECT_EQ(bx < y, bx < by);
+                EXPECT_EQ(bx >= y, bx >= by);
+                EXPECT_EQ(y < bx, by < bx);
+                EXPECT_EQ(y >= bx, by >= bx);
+                EXPECT_EQ(Integer(x) == y, x == y);
+                EXPECT_EQ(Integer(x) < y, x < y);
+            }
+            for (uint32_t m : {1u, 7u, 4'000'000'000u}) {
+                Integer rem = bx - bx / int64_t{m} * int64_t{m};
+                if (rem < 0) {
+                    rem += int64_t{m};
+                }
+                EXPECT_EQ(bx % m, uint32_t(int64_t(rem)));
+            }
+        }
+        EXPECT_THROW(Integer(1) / 0, DivisionByZeroError);
+        EXPECT_THROW(Integer(1) % 0u, DivisionByZeroError);
+    }
+
+    TEST(BigIntegerTests, WordOperators) {
+        CheckWordOperators<BasicBigInteger<magnitude::Limb, 2>>();
+        CheckWordOperators<BasicBigInteger<magnitude::Limb, 10>>();
+        CheckWordOperators<BigInteger>();
+    }
+
+    TEST(BigIntegerTests, MoveSemantics) {
+        BigInteger a = BigInteger::FromString(std::string(200, '7'), 10);
+        BigInteger b = BigInteger::FromString("-" + std::string(150, '3'), 10);
+
+        BigInteger sum = a + b, diff = a - b, prod = a * b, quot = a / b;
+        EXPECT_EQ(BigInteger(a) + b, sum);
+        EXPECT_EQ(a + BigInteger(b), sum);
+        EXPECT_EQ(BigInteger(a) + BigInteger(b), sum);
+        EXPECT_EQ(BigInteger(a) - b, diff);
+        EXPECT_EQ(a - BigInteger(b), diff);
+        EXPECT_EQ(BigInteger(a) - BigInteger(b), diff);
+        EXPECT_EQ(BigInteger(a) * b, prod);
+        EXPECT_EQ(a * BigInteger(b), prod);
+        EXPECT_EQ(BigInteger(a) * BigInteger(b), prod);
+        EXPECT_EQ(BigInteger(a) / b, quot);
+        EXPECT_EQ(BigInteger(a) * 3 - 5, a * 3 - 5);
+        EXPECT_EQ(-7 - BigInteger(a), -7 - a);
+
+        BigInteger c(a);
+        EXPECT_EQ(std::move(c) - c, 0);
+        EXPECT_EQ(a + std::move(a), sum - b + sum - b);
+        a = sum - b;
+
+        BigInteger moved(std::move(a));
+        EXPECT_EQ(a, 0);
+        EXPECT_EQ(moved * moved, prod / b * (prod / b));
+        a = std::move(moved);
+        EXPECT_EQ(moved, 0);
+        EXPECT_EQ(a * (b + b) * -1, b * a * -2);
+        a *= a;
+        EXPECT_EQ(a, prod / b * (prod / b));
+    }
+
+    TEST(BigIntegerTests, SmallVector) {
+        using Small = SmallVector<uint32_t, 2>;
+
+        Small a{1, 2};
+        EXPECT_TRUE(a.IsInline());
+        a.push_back(a[0]);
+        EXPECT_FALSE(a.IsInline());
+        EXPECT_EQ(a, Small({1, 2, 1}));
+
+        Small b(a);
+        b.resize(1);
+        b.insert(b.end(), a.begin(), a.end());
+        EXPECT_EQ(b, Small({1, 1, 2, 1}));
+
+        Small c(std::move(b));
+        EXPECT_TRUE(b.empty());
+        EXPECT_EQ(c.size(), 4u);
+        b = Small(1, 7);
+        EXPECT_TRUE(b.IsInline());
+
+        c = b;
+        EXPECT_EQ(c, Small{7});
+        c.pop_back();
+        EXPECT_NE(c, b);
+    }
+
+    // Counts the blocks handed out and still in use.
+    class CountingResource : public std::pmr::memory_resource {
+     public:
+        int allocated = 0;
+        int live = 0;
+
+     private:
+        void *do_allocate(size_t bytes, size_t alignment) override {
+            allocated++;
+            live++;
+            return upstream.allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+            live--;
+            upstream.deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const memory_resource &other) const
+                noexcept override {
+            return this == &other;
+        }
+
+        std::pmr::monotonic_buffer_resource upstream;
+    };
+
+    TEST(BigIntegerTests, MemoryResource) {
+        BigInteger a = BigInteger::FromString(std::string(200, '9'), 10);
+        BigInteger b = BigInteger::FromString(std::string(150, '7'), 10);
+        BigInteger expected = (a * b + a) / b - a % b;
+
+        CountingResource counting;
+        {
+            BigInteger outside;
+            BigInteger grown(3);
+            {
+                ScopedMemoryResource scope(&counting);
+                BigInteger result = (a * b + a) / b - a % b;
+                EXPECT_EQ(result, expected);
+                EXPECT_GT(counting.allocated, 0);
+                grown *= a * b;
+
+                ScopedMemoryResource nested(std::pmr::new_delete_resource());
+                BigInteger copy = result;
+                EXPECT_EQ(copy, result);
+                outside = std::move(result);
+            }
+            // Numbers from before the scope keep their own storage, so
+            // they may hold its results once the resource is gone.
+            EXPECT_EQ(counting.live, 0);
+            EXPECT_EQ(outside, expected);
+            EXPECT_EQ(grown, a * b * 3);
+        }
+
+        BigInteger total;
+        {
+            std::pmr::monotonic_buffer_resource batch;
+            ScopedMemoryResource scope(&batch);
+            total = a * a;
+        }
+        EXPECT_EQ(total.ToString(10), (a * a).ToString(10));
+
+        int allocated = counting.allocated;
+        BigInteger product = a * b;
+        EXPECT_EQ(counting.allocated, allocated);
+
+        // The radix powers cached by a conversion in scope stay on the
+        // heap, the scope's blocks are all returned when it ends.
+        std::string digits(3'000, '5');
+        CountingResource arena;
+        {
+            ScopedMemoryResource scope(&arena);
+            BigInteger big = BigInteger::FromString(digits, 13);
+            EXPECT_EQ(big.ToString(13), digits);
+        }
+        EXPECT_EQ(arena.live, 0);
+        EXPECT_EQ(BigInteger::FromString(digits, 13).ToString(13), digits);
+    }
+
+    TEST(BigIntegerTests, ThreadPool) {
+        for (size_t threads : {1, 3}) {
+            big_num_arithmetic::ThreadPool pool(threads);
+            EXPECT_EQ(pool.Size(), threads);
+
+            std::vector<int> hits(10'000);
+            std::vector<int64_t> sums(pool.Size());
+            pool.ParallelFor(hits.size(), 7,
+                             [&](size_t begin, size_t end, size_t worker) {
+                for (size_t i = begin; i < end; i++) {
+                    hits[i]++;
+                    sums[worker] += i;
+                }
+                // Nested loops run on the calling worker.
+                pool.ParallelFor(3, 1, [&](size_t, size_t, size_t) {});
+            });
+            EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), 10'000);
+            EXPECT_EQ(std::accumulate(sums.begin(), sums.end(), int64_t{0}),
+                      int64_t{10'000} * 9'999 / 2);
+
+            auto fail = [](size_t begin, size_t end, size_t) {
+                if (begin <= 50 && 50 < end) {
+                    throw std::runtime_error("fail");
+                }
+            };
+            EXPECT_THROW(pool.ParallelFor(100, 1, fail), std::runtime_error);
+        }
+    }
+
+    // Meant to run under -fsanitize=thread as well: the threads share
+    // their inputs read-only and nothing else.
+    TEST(BigIntegerTests, ConcurrentUse) {
+        const std::string decimal(30'000, '7');
+        const BigInteger a = BigInteger::FromString(decimal, 10);
+        const BigInteger b = BigInteger::FromString(std::string(9'000, 'e'),
+                                                    16);
+        const BigInteger m = BigInteger::Pow(BigInteger(2), 521) - 1;
+
+        const BigInteger product = a * b;
+        const std::string septenary = product.ToString(7);
+        const BigInteger power = BigInteger::PowMod(a, b % m, m);
+        const BigInteger gcd = BigInteger::Gcd(product, b * 21);
+
+        std::atomic<int> failures{0};
+        auto work = [&](int id) {
+            // Every thread tunes its own products and allocates from
+            // its own arena or the heap.
+            std::pmr::monotonic_buffer_resource arena;
+            ScopedMemoryResource scope(id % 2
+                                       ? &arena
+                                       : std::pmr::new_delete_resource());
+            multiplication::SetNttThreshold(
+                    id % 3 ? multiplication::kDefaultNttThreshold
+                           : multiplication::kKaratsubaThreshold);
+            for (int i = 0; i < 3; i++) {
+                bool ok = BigInteger::FromString(decimal, 10) == a &&
+                          a.ToString(10) == decimal &&
+                          a * b == product &&
+                          (product / a) == b &&
+                          product.ToString(7) == septenary &&
+                          BigInteger::FromString(septenary, 7) == product &&
+                          BigInteger::PowMod(a, b % m, m) == power &&
+                          BigInteger::Gcd(product, b * 21) == gcd &&
+                          ((product << 100) >> 100) == product;
+                failures += !ok;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int id = 0; id < 6; id++) {
+            threads.emplace_back(work, id);
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        EXPECT_EQ(failures, 0);
+    }
+
+    TEST(BigIntegerTests, UnaryOperators) {
+        std::vector<int64_t> v = GenData(1000);
+
+        for (auto x : v) {
+            BigInteger bx(x);
+
+            ++bx;
+            ++x;
+            EXPECT_EQ(bx, x);
+            bx++;
+            x++;
+            EXPECT_EQ(bx, x);
+            --bx, --x;
+            EXPECT_EQ(bx, x);
+            bx--, x--;
+            EXPECT_EQ(bx, x);
+        }
+    }
+
+    multiplication::Limbs GenLimbs(int size, int64_t base) {
+        std::mt19937 mt(size);
+        std::uniform_int_distribution<int64_t> dist(0, base - 1);
+
+        multiplication::Limbs limbs(size);
+        for (auto &x : limbs) {
+            x = dist(mt);
+        }
+        limbs.back() = std::max<magnitude::Limb>(limbs.back(), 1);
+        return limbs;
+    }
+
+    TEST(BigIntegerTests, FastMultiplication) {
+        using namespace multiplication;
+
+        for (int64_t base : {int64_t{2}, int64_t{7}, int64_t{10'000},
+                              int64_t{1} << 30, kBinaryBase}) {
+            magnitude::Radix radix(base);
+            for (int size : {1, 31, 32, 100, 170, 500}) {
+                for (int other : {size, size / 3 + 1, size * 2}) {
+                    Limbs a = GenLimbs(size, base);
+                    Limbs b = GenLimbs(other, base);
+                    Limbs expected = MultiplySchoolbook(a, b, radix);
+
+                    EXPECT_EQ(Multiply(a, b, radix), expected);
+                    EXPECT_EQ(MultiplyKaratsuba(a, b, radix), expected);
+                    EXPECT_EQ(MultiplyToomCook3(a, b, radix), expected);
+                    EXPECT_EQ(MultiplyNtt(a, b, radix), expected);
+
+                    MultiplyInPlace(a, b, radix);
+                    EXPECT_EQ(a, expected);
+                }
+            }
+        }
+    }
+
+    TEST(BigIntegerTests, NttMultiplication) {
+        using namespace multiplication;
+
+        for (int64_t base : {int64_t{10'000}, int64_t{INT32_MAX},
+                              kBinaryBase}) {
+            magnitude::Radix radix(base);
+            Limbs a = GenLimbs(5'000, base);
+            Limbs b = GenLimbs(3'000, base);
+            Limbs expected = MultiplyToomCook3(a, b, radix);
+
+            EXPECT_EQ(MultiplyNtt(a, b, radix), expected);
+            EXPECT_EQ(MultiplyNtt(a, a, radix), MultiplyToomCook3(a, a, radix));
+
+            size_t threshold = GetNttThreshold();
+            SetNttThreshold(kKaratsubaThreshold);
+            EXPECT_EQ(Multiply(a, b, radix), expected);
+            SetNttThreshold(threshold);
+        }
+    }
+
+    TEST(BigIntegerTests, ParallelMultiplication) {
+        using namespace multiplication;
+
+        for (int64_t base : {int64_t{1'000'000'000}, kBinaryBase}) {
+            magnitude::Radix radix(base);
+            Limbs a = GenLimbs(20'000, base);
+            Limbs b = GenLimbs(9'000, base);
+            Limbs c = GenLimbs(700, base);
+
+            Limbs product = Multiply(a, b, radix);
+            Limbs square = Multiply(a, a, radix);
+            Limbs unbalanced = Multiply(a, c, radix);
+            Limbs toom = MultiplyToomCook3(b, GenLimbs(8'000, base), radix);
+
+            // Without the NTT, a times d is cut into pieces of d that
+            // are long enough to share among the threads.
+            size_t threshold = GetNttThreshold();
+            SetNttThreshold(kMaxNttLength);
+            Limbs d = GenLimbs(kParallelThreshold + 500, base);
+            Limbs pieces = Multiply(a, d, radix);
+
+            big_num_arithmetic::ThreadPool pool(3);
+            ScopedThreadPool scope(&pool);
+            EXPECT_EQ(Multiply(a, b, radix), product);
+            EXPECT_EQ(Multiply(a, a, radix), square);
+            EXPECT_EQ(Multiply(a, c, radix), unbalanced);
+            EXPECT_EQ(MultiplyToomCook3(b, GenLimbs(8'000, base), radix),
+                      toom);
+            EXPECT_EQ(Multiply(a, d, radix), pieces);
+            SetNttThreshold(threshold);
+        }
+
+        BigInteger x = BigInteger::FromString(std::string(60'000, '8'), 10);
+        x = x * x + 12'345;
+        std::string decimal = x.ToString(10);
+        std::string septenary = x.ToString(7);
+
+        big_num_arithmetic::ThreadPool pool(4);
+        ScopedThreadPool scope(&pool);
+        EXPECT_EQ(x.ToString(10), decimal);
+        EXPECT_EQ(x.ToString(7), septenary);
+        EXPECT_EQ(BigInteger::FromString(decimal, 10), x);
+        EXPECT_EQ(BigInteger::FromString(septenary, 7), x);
+        EXPECT_EQ(BigInteger::FromString("000" + decimal, 10), x);
+    }
+
+    TEST(BigIntegerTests, SimdKernels) {
+        using magnitude::Limb;
+        const simd::Kernels &scalar = simd::Supported().front();
+
+        for (int64_t base : {int64_t{2}, int64_t{10}, int64_t{1} << 31,
+                             (int64_t{1} << 31) + 1, kBinaryBase}) {
+            magnitude::Radix radix(base);
+            for (int size : {0, 3, 8, 13, 100}) {
+                // Runs of base - 1 make the carries ripple through blocks.
+                std::vector<Limb> a(size, Limb(base - 1)), b(size, 0);
+                magnitude::Limbs r = GenLimbs(size + 1, base);
+                for (int i = 0; i < size; i++) {
+                    if (r[i] % 3 == 0) {
+                        a[i] = r[i];
+                    }
+                    b[i] = (i % 5 == 0 ? r[size - i] : a[i]);
+                }
+
+                for (const simd::Kernels &k : simd::Supported()) {
+                    for (Limb carry : {0, 1}) {
+                        std::vector<Limb> expected(size), actual(size);
+                        EXPECT_EQ(k.add(actual.data(), a.data(), b.data(),
+                                        size, carry, radix),
+                                  scalar.add(expected.data(), a.data(),
+                                             b.data(), size, carry, radix))
+                                << k.name;
+                        EXPECT_EQ(actual, expected) << k.name;
+
+                        EXPECT_EQ(k.sub(actual.data(), a.data(), b.data(),
+                                        size, carry, radix),
+                                  scalar.sub(expected.data(), a.data(),
+                                             b.data(), size, carry, radix))
+                                << k.name;
+                        EXPECT_EQ(actual, expected) << k.name;
+                    }
+                    EXPECT_EQ(k.compare(a.data(), b.data(), size),
+                              scalar.compare(a.data(), b.data(), size));
+                    EXPECT_EQ(k.compare(a.data(), a.data(), size), 0);
+                }
+            }
+        }
+    }
+
+    TEST(BigIntegerTests, LongDivision) {
+        using multiplication::Limbs;
+
+        for (int64_t base : {int64_t{2}, int64_t{10}, int64_t{10'000},
+                              int64_t{1} << 30, kBinaryBase}) {
+            magnitude::Radix radix(base);
+            for (int size : {1, 2, 5, 40, 300}) {
+                for (int other : {1, 2, 3, size / 2 + 1, size}) {
+                    Limbs u = GenLimbs(size, base);
+                    Limbs v = GenLimbs(other, base);
+                    v.back() /= (size % 7 + 1);
+                    v.back() = std::max<magnitude::Limb>(v.back(), 1);
+
+                    Limbs q, r;
+                    division::DivMod(u, v, radix, q, r);
+
+                    EXPECT_LT(magnitude::Compare(r, v), 0);
+                    Limbs restored = multiplication::Multiply(q, v, radix);
+                    magnitude::AddShifted(restored, r, 0, radix);
+                    magnitude::Trim(restored);
+                    EXPECT_EQ(restored, u);
+                }
+            }
+        }
+    }
+
+    TEST(BigIntegerTests, NewtonDivision) {
+        using multiplication::Limbs;
+
+        for (int64_t base : {int64_t{10'000}, int64_t{INT32_MAX},
+                              kBinaryBase}) {
+            magnitude::Radix radix(base);
+            Limbs v = GenLimbs(division::kNewtonThreshold + 100, base);
+            Limbs pow(2 * v.size() + 1, 0);
+            pow.back() = 1;
+
+            Limbs q, r;
+            division::DivModKnuth(pow, v, radix, q, r);
+            EXPECT_EQ(division::Reciprocal(v, radix), q);
+
+            for (size_t size : {v.size() + 800, 2 * v.size(), 5 * v.size()}) {
+                Limbs u = GenLimbs(size, base);
+                Limbs expected_q, expected_r;
+                division::DivModKnuth(u, v, radix, expected_q, expected_r);
+
+                division::DivMod(u, v, radix, q, r);
+                EXPECT_EQ(q, expected_q);
+                EXPECT_EQ(r, expected_r);
+            }
+        }
+    }
+
+    TEST(BigIntegerTests, BarrettReducer) {
+        BigInteger m = BigInteger::FromString(std::string(500, '3'), 10);
+        BarrettReducer reducer(m);
+
+        for (int64_t k : {0, 1, 7, -5, 123'456}) {
+            BigInteger x = m * m * k + m * 2 - BigInteger(k);
+            BigInteger quotient, remainder;
+            reducer.DivMod(x, quotient, remainder);
+
+            EXPECT_EQ(quotient, x / m);
+            EXPECT_EQ(remainder, x - (x / m) * m);
+
+            BigInteger reduced = reducer.Reduce(x);
+            EXPECT_GE(reduced, 0);
+            EXPECT_LT(reduced, m);
+            EXPECT_EQ((x - reduced) - ((x - reduced) / m) * m, 0);
+        }
+        EXPECT_THROW(BarrettReducer(BigInteger(0)), DivisionByZeroError);
+    }
+
+    TEST(BigIntegerTests, BigModulo) {
+        std::vector<int64_t> v = GenData(100);
+        for (int64_t x : v) {
+            for (int64_t y : {int64_t{3}, int64_t{-7}, int64_t{1} << 40,
+                              x / 3 + 1}) {
+                if (y == 0) {
+                    continue;
+                }
+                BigInteger a(x);
+                EXPECT_EQ(a % BigInteger(y), x % y);
+                a %= BigInteger(y);
+                EXPECT_EQ(a, x % y);
+            }
+        }
+        EXPECT_THROW(BigInteger(5) % BigInteger(0), DivisionByZeroError);
+    }
+
+    template<typename Integer>
+    void CheckPowMod() {
+        int64_t x = 1;
+        for (int e = 0; e < 40; e++) {
+            EXPECT_EQ(Integer::Pow(Integer(3), e), x);
+            EXPECT_EQ(Integer::Pow(Integer(-3), e), e % 2 ? -x : x);
+            x *= 3;
+        }
+
+        for (int64_t m : {int64_t{1}, int64_t{2}, int64_t{97},
+                          int64_t{1'000'000'007}, int64_t{1} << 40,
+                          int64_t{600'000'000'000}, int64_t{-45}}) {
+            for (int64_t b : {int64_t{0}, int64_t{5}, int64_t{-123'456},
+                              int64_t{987'654'321'012}}) {
+                for (int64_t e : {0, 1, 2, 31, 1'000, 65'537}) {
+                    Integer modulus(m < 0 ? -m : m);
+                    Integer expected(1);
+                    Integer square(b);
+                    for (int64_t k = e; k; k >>= 1) {
+                        if (k & 1) {
+                            expected = (expected * square) % modulus;
+                        }
+                        square = (square * square) % modulus;
+                    }
+                    expected = (expected + modulus) % modulus;
+
+                    EXPECT_EQ(Integer::PowMod(Integer(b), Integer(e),
+                                              Integer(m)),
+                              expected) << b << " " << e << " " << m;
+                }
+            }
+        }
+
+        Integer m = Integer::FromString(std::string(150, '7'), 10);
+        Integer e = Integer::FromString(std::string(40, '9'), 10);
+        Integer a = Integer::FromString(std::string(100, '4'), 10);
+        // Fermat's little theorem for the Mersenne prime 2^127 - 1.
+        Integer p = Integer::Pow(Integer(2), 127) - Integer(1);
+        EXPECT_EQ(Integer::PowMod(a, p - Integer(1), p), 1);
+        EXPECT_EQ(Integer::PowMod(a, p, p), a % p);
+
+        Integer expected(1);
+        for (int i = 0; i < 10; i++) {
+            expected = expected * a % m;
+        }
+        EXPECT_EQ(Integer::PowMod(a, Integer(10), m), expected);
+        EXPECT_EQ(Integer::PowMod(a, e * Integer(2), m),
+                  Integer::PowMod(Integer::PowMod(a, e, m), Integer(2), m));
+
+        EXPECT_THROW(Integer::PowMod(a, Integer(-1), m), std::logic_error);
+        EXPECT_THROW(Integer::PowMod(a, e, Integer(0)), DivisionByZeroError);
+    }
+
+    TEST(BigIntegerTests, PowMod) {
+        CheckPowMod<BasicBigInteger<magnitude::Limb, 10>>();
+        CheckPowMod<BasicBigInteger<magnitude::Limb, 1'000'000'000>>();
+        CheckPowMod<BigInteger>();
+    }
+
+    TEST(BigIntegerTests, MontgomeryContext) {
+        BigInteger m = BigInteger::FromString(std::string(300, '3'), 10);
+        MontgomeryContext context(m);
+        EXPECT_EQ(context.Modulus(), m);
+
+        BigInteger a = BigInteger::FromString(std::string(280, '5'), 10);
+        BigInteger b = a * a * BigInteger(-17);
+        BigInteger ma = context.ToMontgomery(a);
+        BigInteger mb = context.ToMontgomery(b);
+        EXPECT_EQ(context.FromMontgomery(ma), a);
+
+        BigInteger product = (a * b) % m;
+        product += m;
+        EXPECT_EQ(context.FromMontgomery(context.Multiply(ma, mb)),
+                  product % m);
+
+        BigInteger e = BigInteger::FromString("123456789123456789", 10);
+        EXPECT_EQ(context.FromMontgomery(context.Pow(ma, e)),
+                  BigInteger::PowMod(a, e, m));
+        EXPECT_EQ(context.FromMontgomery(context.Pow(ma, BigInteger(0))), 1);
+
+        EXPECT_THROW(MontgomeryContext(BigInteger(10)), std::logic_error);
+        EXPECT_THROW(MontgomeryContext(BigInteger(0)), DivisionByZeroError);
+    }
+
+    template<typename Integer>
+    void CheckBitwise() {
+        std::mt19937_64 mt(7);
+        for (int i = 0; i < 2'000; i++) {
+            int64_t a = int64_t(mt()) >> (mt() % 62);
+            int64_t b = int64_t(mt()) >> (mt() % 62);
+            int shift = mt() % 62;
+            Integer x(a), y(b);
+
+            EXPECT_EQ(x & y, a & b) << a << " " << b;
+            EXPECT_EQ(x | y, a | b) << a << " " << b;
+            EXPECT_EQ(x ^ y, a ^ b) << a << " " << b;
+            EXPECT_EQ(~x, ~a) << a;
+            EXPECT_EQ(x >> shift, a >> shift) << a << " " << shift;
+            if ((a << shift >> shift) == a) {
+                EXPECT_EQ(x << shift, a << shift) << a << " " << shift;
+            }
+
+            uint64_t ones = (a < 0 ? ~uint64_t(a) : uint64_t(a));
+            EXPECT_EQ(x.BitLength(), size_t(64 - (ones ? __builtin_clzll(ones)
+                                                       : 64)));
+            EXPECT_EQ(x.PopCount(), size_t(__builtin_popcountll(ones)));
+        }
+
+        Integer big = Integer::FromString(std::string(200, '9'), 10);
+        Integer power = Integer::Pow(Integer(2), 777);
+        EXPECT_EQ(Integer(1) << 777, power);
+        EXPECT_EQ((big << 777) >> 777, big);
+        EXPECT_EQ(big << 777, big * power);
+        EXPECT_EQ(big >> 100, big / Integer::Pow(Integer(2), 100));
+        EXPECT_EQ((big * -1) >> 2'000, -1);
+        EXPECT_EQ(big >> 2'000, 0);
+        EXPECT_EQ(power.BitLength(), 778u);
+        EXPECT_EQ(power.PopCount(), 1u);
+        EXPECT_EQ((power * -1).BitLength(), 777u);
+        EXPECT_EQ((power - 1).PopCount(), 777u);
+        EXPECT_EQ((big & (big * -1)) ^ big, big & (big - 1));
+        EXPECT_EQ(~(big | power), ~big & ~power);
+        EXPECT_EQ(Integer(0).BitLength(), 0u);
+    }
+
+    TEST(BigIntegerTests, Bitwise) {
+        CheckBitwise<BasicBigInteger<magnitude::Limb, 10>>();
+        CheckBitwise<BasicBigInteger<magnitude::Limb, 1 << 16>>();
+        CheckBitwise<BigInteger>();
+    }
+
+    template<typename Integer>
+    void CheckGcd() {
+        std::mt19937_64 mt(11);
+        for (int i = 0; i < 2'000; i++) {
+            int64_t a = int64_t(mt() >> (1 + mt() % 63)) * (i % 3 ? 1 : -1);
+            int64_t b = int64_t(mt() >> (1 + mt() % 63)) * (i % 5 ? 1 : -1);
+            if (i % 7 == 0) {
+                b = 0;
+            }
+            Integer x, y;
+            Integer gcd = Integer::ExtendedGcd(Integer(a), Integer(b), x, y);
+            EXPECT_EQ(gcd, int64_t(std::gcd(a, b))) << a << " " << b;
+            EXPECT_EQ(Integer::Gcd(Integer(a), Integer(b)), gcd);
+            EXPECT_EQ(x * Integer(a) + y * Integer(b), gcd);
+        }
+
+        // Fibonacci neighbours take the longest Euclid chains.
+        Integer f0(0), f1(1);
+        for (int i = 0; i < 3'000; i++) {
+            f0 += f1;
+            std::swap(f0, f1);
+        }
+        Integer x, y;
+        EXPECT_EQ(Integer::ExtendedGcd(f1, f0, x, y), 1);
+        EXPECT_EQ(x * f1 + y * f0, 1);
+        EXPECT_EQ(Integer::Gcd(f1, f0), 1);
+
+        Integer p = Integer::Pow(Integer(2), 127) - 1;
+        Integer c = Integer::FromString(std::string(150, '7'), 10) * 6;
+        Integer d = Integer::FromString(std::string(170, '3'), 10) * 8;
+        EXPECT_EQ(Integer::Gcd(c * p, d * p), Integer::Gcd(c, d) * p);
+        EXPECT_EQ(Integer::Gcd(c, d) % 2, 0u);
+        Integer g = Integer::ExtendedGcd(c * p, d * p * -1, x, y);
+        EXPECT_EQ(x * c * p - y * d * p, g);
+
+        Integer inverse = Integer::ModInverse(c, p);
+        EXPECT_EQ((inverse * c) % p, 1);
+        EXPECT_EQ(Integer::ModInverse(Integer(-3), Integer(7)), 2);
+        EXPECT_EQ(Integer::ModInverse(Integer(5), Integer(1)), 0);
+        EXPECT_THROW(Integer::ModInverse(Integer(6), Integer(9)),
+                     std::logic_error);
+        EXPECT_THROW(Integer::ModInverse(Integer(6), Integer(0)),
+                     DivisionByZeroError);
+        EXPECT_EQ(Integer::Gcd(Integer(0), Integer(0)), 0);
+    }
+
+    TEST(BigIntegerTests, Gcd) {
+        CheckGcd<BasicBigInteger<magnitude::Limb, 10>>();
+        CheckGcd<BasicBigInteger<magnitude::Limb, 1'000'000'000>>();
+        CheckGcd<BigInteger>();
+    }
+
+    template<typename Integer>
+    void CheckSerialization() {
+        std::vector<BigInteger> values{
+                BigInteger(0), BigInteger(1), BigInteger(-1),
+                BigInteger(std::numeric_limits<int64_t>::min()),
+                BigInteger::Pow(BigInteger(2), 32),
+                BigInteger::FromString(std::string(500, '8'), 10) * -3};
+
+        // Written from Integer, read back as BigInteger and the other way
+        // round, the format does not depend on the base.
+        std::stringstream stream;
+        std::string buffer;
+        for (const BigInteger &value : values) {
+            Integer x = Integer::FromString(value.ToString(10), 10);
+            x.Serialize(stream);
+            size_t offset = buffer.size();
+            buffer.resize(offset + x.SerializedSize());
+            EXPECT_EQ(x.Serialize(&buffer[offset]), x.SerializedSize());
+        }
+        EXPECT_EQ(stream.str(), buffer);
+
+        const char *data = buffer.data();
+        const char *end = data + buffer.size();
+        for (const BigInteger &value : values) {
+            EXPECT_EQ(BigInteger::Deserialize(stream), value);
+            BigIntegerView view = BigIntegerView::Parse(data, end - data);
+            EXPECT_EQ(view.Sign(), value.Sign());
+            EXPECT_EQ(Integer::Deserialize(view).ToString(10),
+                      value.ToString(10));
+            EXPECT_EQ(Integer::Deserialize(data, end - data),
+                      Integer::Deserialize(view));
+            data = view.End();
+        }
+        EXPECT_EQ(data, end);
+        EXPECT_THROW(BigInteger::Deserialize(stream), std::runtime_error);
+    }
+
+    TEST(BigIntegerTests, Serialization) {
+        CheckSerialization<BasicBigInteger<magnitude::Limb, 10>>();
+        CheckSerialization<BasicBigInteger<magnitude::Limb, 1 << 16>>();
+        CheckSerialization<BigInteger>();
+
+        BigInteger x = BigInteger::Pow(BigInteger(3), 1'000) * -1;
+        std::string bytes(x.SerializedSize(), '\0');
+        x.Serialize(&bytes[0]);
+        EXPECT_EQ(bytes.size(), 8 + 4 * ((x.BitLength() + 31) / 32));
+        BigIntegerView view = BigIntegerView::Parse(bytes.data(),
+                                                    bytes.size());
+        EXPECT_EQ(view.Size(), (bytes.size() - 8) / 4);
+        EXPECT_EQ(view.Word(0),
+                  uint32_t(int64_t(x * -1 & BigInteger(0xffffffff))));
+
+        // Truncated words, a negative zero and a leading zero word.
+        EXPECT_THROW(BigIntegerView::Parse(bytes.data(), bytes.size() - 1),
+                     std::runtime_error);
+        EXPECT_THROW(BigIntegerView::Parse(bytes.data(), 7),
+                     std::runtime_error);
+        std::string zero(8, '\0');
+        zero[7] = char(0x80);
+        EXPECT_THROW(BigInteger::Deserialize(zero.data(), zero.size()),
+                     std::runtime_error);
+        std::string padded = bytes;
+        padded[0] = char(padded[0] + 1);
+        padded.append(4, '\0');
+        EXPECT_THROW(BigInteger::Deserialize(padded.data(), padded.size()),
+                     std::runtime_error);
+        std::istringstream short_stream(bytes.substr(0, 20));
+        EXPECT_THROW(BigInteger::Deserialize(short_stream),
+                     std::runtime_error);
+
+        std::string path = testing::TempDir() + "serialization_test.bin";
+        {
+            std::ofstream out(path, std::ios::binary);
+            for (int i = 0; i < 100; i++) {
+                (x + i).Serialize(out);
+            }
+        }
+        {
+            MappedFile file(path.c_str());
+            const char *data = file.Data();
+            for (int i = 0; i < 100; i++) {
+                BigIntegerView value = BigIntegerView::Parse(
+                        data, file.Data() + file.Size() - data);
+                EXPECT_EQ(BigInteger::Deserialize(value), x + i);
+                data = value.End();
+            }
+            EXPECT_EQ(data, file.Data() + file.Size());
+        }
+        std::remove(path.c_str());
+    }
+
+    template<typename Integer>
+    void CheckAddMul() {
+        std::mt19937 mt(13);
+        auto random = [&mt](int max_digits) {
+            std::string digits(1 + mt() % max_digits, '0');
+            for (auto &c : digits) {
+                c = char('0' + mt() % 10);
+            }
+            Integer x = Integer::FromString(digits, 10);
+            return (mt() % 2 ? x : x * -1);
+        };
+
+        // Up to 800 digits, past the Karatsuba threshold of every base.
+        for (int i = 0; i < 300; i++) {
+            int digits = (i % 10 ? 40 : 800);
+            Integer acc = random(digits), x = random(digits),
+                    y = random(digits);
+            if (i % 17 == 0) {
+                acc = x * y;
+            }
+
+            Integer sum = acc;
+            Integer::AddMul(sum, x, y);
+            EXPECT_EQ(sum, acc + x * y);
+            Integer difference = acc;
+            Integer::SubMul(difference, x, y);
+            EXPECT_EQ(difference, acc - x * y);
+        }
+
+        Integer x = random(100);
+        Integer square = x;
+        Integer::AddMul(square, square, square);
+        EXPECT_EQ(square, x + x * x);
+        Integer zero(0);
+        Integer::SubMul(zero, x, Integer(0));
+        EXPECT_EQ(zero, 0);
+
+        for (int count : {0, 1, 5, 40}) {
+            std::vector<Integer> lhs, rhs;
+            Integer expected(0);
+            for (int i = 0; i < count; i++) {
+                lhs.push_back(random(i % 7 ? 30 : 700));
+                rhs.push_back(random(i % 7 ? 30 : 700));
+                expected += lhs.back() * rhs.back();
+            }
+            EXPECT_EQ(Integer::DotProduct(lhs.data(), rhs.data(), count),
+                      expected);
+        }
+
+        // Products that cancel exactly, and a negative sum.
+        Integer a = random(200), b = random(200);
+        Integer lhs[] = {a, a, b};
+        Integer rhs[] = {b, b * -1, Integer(-1)};
+        EXPECT_EQ(Integer::DotProduct(lhs, rhs, 2), 0);
+        EXPECT_EQ(Integer::DotProduct(lhs + 1, rhs + 1, 2), a * b * -1 - b);
+    }
+
+    TEST(BigIntegerTests, AddMul) {
+        CheckAddMul<BasicBigInteger<magnitude::Limb, 10>>();
+        CheckAddMul<BasicBigInteger<magnitude::Limb, 1'000'000'000>>();
+        CheckAddMul<BigInteger>();
+    }
+
+    template<size_t Bits>
+    void CheckFixedInteger() {
+        using Fixed = FixedInteger<Bits>;
+        BigInteger modulus = BigInteger(1) << Bits;
+        BigInteger half = BigInteger(1) << (Bits - 1);
+        // value modulo 2^Bits in [-2^(Bits - 1), 2^(Bits - 1)).
+        auto wrap = [&](const BigInteger &value) {
+            return ((value + half) & (modulus - 1)) - half;
+        };
+
+        std::mt19937 mt(17);
+        auto random = [&] {
+            BigInteger x(0);
+            size_t bits = 1 + mt() % (Bits + 40);
+            for (size_t i = 0; i < bits; i += 32) {
+                x = (x << 32) + int64_t(mt());
+            }
+            x >>= (bits + 31) / 32 * 32 - bits;
+            return (mt() % 2 ? x : x * -1);
+        };
+
+        std::vector<BigInteger> values{
+                BigInteger(0), BigInteger(1), BigInteger(-1),
+                half - 1, half * -1, BigInteger(int64_t(1) << 40)};
+        for (int i = 0; i < 200; i++) {
+            values.push_back(random());
+        }
+
+        for (size_t i = 0; i < values.size(); i++) {
+            BigInteger a = wrap(values[i]);
+            BigInteger b = wrap(values[(i * 7 + 3) % values.size()]);
+            Fixed x(values[i]);
+            Fixed y(values[(i * 7 + 3) % values.size()]);
+            EXPECT_EQ(BigInteger(x), a);
+            EXPECT_EQ(x.Sign(), a.Sign());
+
+            EXPECT_EQ(BigInteger(x + y), wrap(a + b));
+            EXPECT_EQ(BigInteger(x - y), wrap(a - b));
+            EXPECT_EQ(BigInteger(x * y), wrap(a * b));
+            EXPECT_EQ(BigInteger(-x), wrap(a * -1));
+            EXPECT_EQ(BigInteger(x ^ ~y), a ^ ~b);
+            EXPECT_EQ(x < y, a < b);
+            EXPECT_EQ(x == y, a == b);
+            if (b != 0) {
+                EXPECT_EQ(BigInteger(x / y), wrap(a / b));
+                EXPECT_EQ(BigInteger(x % y), a % b);
+            }
+            size_t shift = mt() % (Bits + 8);
+            EXPECT_EQ(BigInteger(x << shift), wrap(a << shift));
+            EXPECT_EQ(BigInteger(x >> shift), a >> shift);
+        }
+
+        EXPECT_EQ(BigInteger(Fixed::Min()), half * -1);
+        EXPECT_EQ(BigInteger(Fixed::Max()), half - 1);
+        EXPECT_EQ(Fixed::Min() / Fixed(-1), Fixed::Min());
+        EXPECT_EQ(Fixed::Min() * Fixed(-1), Fixed::Min());
+        EXPECT_EQ(Fixed(-3) * Fixed(-5), Fixed(15));
+        EXPECT_EQ(Fixed(7) * Fixed(-6), Fixed(-42));
+        EXPECT_EQ(++Fixed(Fixed::Max()), Fixed::Min());
+        EXPECT_EQ(int64_t(Fixed(INT64_MIN)), INT64_MIN);
+        EXPECT_THROW(Fixed(1) / Fixed(0), DivisionByZeroError);
+        EXPECT_EQ(Fixed(-12345).ToString(10), "-12345");
+        if (Bits > 64) {
+            EXPECT_THROW(int64_t(Fixed::Max()), std::runtime_error);
+
+            using Decimal = BasicBigInteger<magnitude::Limb, 10>;
+            Decimal d = Decimal::FromString("-" + std::string(30, '7'), 10);
+            EXPECT_EQ(Decimal(Fixed(d)), d);
+        }
+    }
+
+    TEST(BigIntegerTests, FixedInteger) {
+        CheckFixedInteger<64>();
+        CheckFixedInteger<128>();
+        CheckFixedInteger<256>();
+        CheckFixedInteger<4096>();
+
+        // Evaluated by the compiler.
+        constexpr Int256 kTen(10);
+        constexpr Int256 kBig = (Int256(1) << 200) - kTen;
+        static_assert(kBig % kTen == Int256(6), "");
+        static_assert(kBig / kTen * kTen + Int256(6) == kBig, "");
+        static_assert((-kBig >> 190) == Int256(-1024), "");
+        static_assert(-kBig * -kTen == kBig * kTen, "");
+        static_assert(int64_t(Int128::Max() >> 100) == (int64_t(1) << 27) - 1,
+                      "");
+    }
+
+    TEST(BigIntegerTests, LargeQuotients) {
+        BigInteger a = BigInteger::FromString(std::string(1'000, '9'), 10);
+        BigInteger b = BigInteger::FromString(std::string(300, '7'), 10);
+        BigInteger c(123'456'789);
+
+        BigInteger n = a * b + c;
+        EXPECT_EQ(n / b, a);
+        EXPECT_EQ(n / a, b);
+        EXPECT_EQ(n - (n / a) * a, c);
+        EXPECT_EQ((n * -1) / b, a * -1);
+        EXPECT_EQ((a * b) / (a * b), 1);
+        EXPECT_EQ(a % 7, 3u);
+    }
+
+    TEST(BigIntegerTests, LargeProducts) {
+        BigInteger a = BigInteger::FromString(std::string(3'000, '7'), 10);
+        BigInteger b = BigInteger::FromString(std::string(2'000, '3'), 10);
+        b.Negate();
+
+        BigInteger sum = a + b;
+        EXPECT_EQ(sum * sum, a * a + a * b * 2 + b * b);
+        EXPECT_EQ((a * b).Sign(), -1);
+        EXPECT_EQ(a * b, b * a);
+    }
+}  // namespace big_num_arithmetic
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include "bitwise.h"
+#include "radix_conversion.h"
+
+namespace big_num_arithmetic {
+
+namespace bitwise {
+
+using magnitude::Limb;
+using magnitude::Wide;
+
+namespace {
+
+    constexpr int kWordBits = 32;
+    constexpr uint64_t kBinaryBase = uint64_t(1) << kWordBits;
+
+    // Regroups a stream of from-bit values into to-bit values, both
+    // little endian and at most 32 bits wide.
+    Limbs Repack(const Limb *values, size_t count, int from, int to) {
+        Limbs res;
+        res.reserve((count * from + to - 1) / to);
+        uint64_t mask = (uint64_t(1) << to) - 1;
+        uint64_t acc = 0;
+        int filled = 0;
+        for (size_t i = 0; i < count; i++) {
+            acc |= uint64_t(values[i]) << filled;
+            filled += from;
+            while (filled >= to) {
+                res.push_back(Limb(acc & mask));
+                acc >>= to;
+                filled -= to;
+            }
+        }
+        if (filled) {
+            res.push_back(Limb(acc));
+        }
+        magnitude::Trim(res);
+        return res;
+    }
+
+    // One word of the two's complement of a number when negative, the
+    // carry starts at one on the lowest word.
+    Limb Complement(Limb word, bool negative, Limb &carry) {
+        if (!negative) {
+            return word;
+        }
+        Wide sum = Wide(Limb(~word)) + carry;
+        carry = Limb(sum >> kWordBits);
+        return Limb(sum);
+    }
+
+    Limb Combine(Operation op, Limb a, Limb b) {
+        switch (op) {
+            case Operation::kAnd:
+                return a & b;
+            case Operation::kOr:
+                return a | b;
+            default:
+                return a ^ b;
+        }
+    }
+
+}  // namespace
+
+    Limbs ToBinary(const Limbs &a, const Radix &radix) {
+        if (radix.Base() == kBinaryBase) {
+            Limbs res(a);
+            magnitude::Trim(res);
+            return res;
+        }
+        if (radix.IsPowerOfTwo()) {
+            return Repack(a.data(), a.size(), radix.Bits(), kWordBits);
+        }
+
+        // Through hexadecimal digits, which are 4-bit values.
+        radix_conversion::Digits digits = radix_conversion::ToDigits(a, 16,
+                                                                     radix);
+        Limbs nibbles(digits.rbegin(), digits.rend());
+        return Repack(nibbles.data(), nibbles.size(), 4, kWordBits);
+    }
+
+    Limbs FromBinary(const Limbs &words, const Radix &radix) {
+        if (radix.Base() == kBinaryBase) {
+            Limbs res(words);
+            magnitude::Trim(res);
+            return res;
+        }
+        if (radix.IsPowerOfTwo()) {
+            return Repack(words.data(), words.size(), kWordBits,
+                          radix.Bits());
+        }
+
+        Limbs nibbles = Repack(words.data(), words.size(), kWordBits, 4);
+        // Digits are most significant first.
+        radix_conversion::Digits digits(nibbles.size());
+        for (size_t i = 0; i < nibbles.size(); i++) {
+            digits[i] = nibbles[nibbles.size() - 1 - i];
+        }
+        return radix_conversion::FromDigits(digits, 16, radix);
+    }
+
+    void Apply(Operation op,
+               const Limbs &a, bool a_negative,
+               const Limbs &b, bool b_negative,
+               Limbs &result, bool &negative) {
+        // One word more than either operand holds the sign extension.
+        size_t n = std::max(a.size(), b.size()) + 1;
+        negative = Combine(op, a_negative, b_negative);
+
+        Limbs res(n);
+        Limb a_carry = 1, b_carry = 1, carry = 1;
+        for (size_t i = 0; i < n; i++) {
+            Limb x = Complement(i < a.size() ? a[i] : 0, a_negative, a_carry);
+            Limb y = Complement(i < b.size() ? b[i] : 0, b_negative, b_carry);
+            // A negative result goes back to its magnitude the same way.
+            res[i] = Complement(Combine(op, x, y), negative, carry);
+        }
+        magnitude::Trim(res);
+        result = std::move(res);
+    }
+
+    void ShiftLeft(Limbs &a, size_t bits, const Radix &radix) {
+        magnitude::Trim(a);
+        if (a.empty()) {
+            return;
+        }
+
+        int limb_bits = radix.Bits();
+        size_t whole = bits / limb_bits;
+        int rest = bits % limb_bits;
+        Wide mask = radix.Base() - 1;
+
+        Limbs res(a.size() + whole + 1, 0);
+        for (size_t i = 0; i < a.size(); i++) {
+            Wide cur = Wide(a[i]) << rest;
+            res[i + whole] |= Limb(cur & mask);
+            res[i + whole + 1] |= Limb(cur >> limb_bits);
+        }
+        magnitude::Trim(res);
+        a = std::move(res);
+    }
+
+    bool ShiftRight(Limbs &a, size_t bits, const Radix &radix) {
+        magnitude::Trim(a);
+        int limb_bits = radix.Bits();
+        size_t whole = bits / limb_bits;
+        int rest = bits % limb_bits;
+        if (whole >= a.size()) {
+            bool lost = !a.empty();
+            a.clear();
+            return lost;
+        }
+
+        bool lost = (a[whole] & ((Wide(1) << rest) - 1)) != 0;
+        for (size_t i = 0; i < whole && !lost; i++) {
+            lost = (a[i] != 0);
+        }
+
+        Wide mask = radix.Base() - 1;
+        for (size_t i = whole; i < a.size(); i++) {
+            Wide high = (i + 1 < a.size() ? a[i + 1] : 0);
+            a[i - whole] = Limb((a[i] >> rest) |
+                                ((high << (limb_bits - rest)) & mask));
+        }
+        a.resize(a.size() - whole);
+        magnitude::Trim(a);
+        return lost;
+    }
+
+    size_t BitLength(const Limbs &words) {
+        if (words.empty()) {
+            return 0;
+        }
+        return (words.size() - 1) * kWordBits +
+               (kWordBits - __builtin_clz(words.back()));
+    }
+
+    size_t PopCount(const Limbs &words) {
+        size_t count = 0;
+        for (Limb word : words) {
+            count += __builtin_popcount(word);
+        }
+        return count;
+    }
+
+}  // namespace bitwise
+
+}  // namespace big_num_arithmetic
@@ -0,0 +1,48 @@
+#ifndef BITWISE_H_
+#define BITWISE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include "magnitude.h"
+
+namespace big_num_arithmetic {
+
+// Bit-level operations. The logic ones work on binary words, little
+// endian limbs of 32 bits whatever the base of the number is.
+namespace bitwise {
+
+using Limbs = magnitude::Limbs;
+using magnitude::Radix;
+
+// Converts a magnitude to binary words and back, a copy for the binary
+// base and a bit repacking for other power of two bases.
+Limbs ToBinary(const Limbs &a, const Radix &radix);
+Limbs FromBinary(const Limbs &words, const Radix &radix);
+
+enum class Operation {
+    kAnd,
+    kOr,
+    kXor
+};
+
+// op on the infinite two's complement forms of the signed magnitudes
+// a and b, all of them binary words.
+void Apply(Operation op,
+           const Limbs &a, bool a_negative,
+           const Limbs &b, bool b_negative,
+           Limbs &result, bool &negative);
+
+// a * 2^bits and a / 2^bits for a power of two radix. ShiftRight tells
+// whether any one bits were dropped.
+void ShiftLeft(Limbs &a, size_t bits, const Radix &radix);
+bool ShiftRight(Limbs &a, size_t bits, const Radix &radix);
+
+// Both take trimmed binary words.
+size_t BitLength(const Limbs &words);
+size_t PopCount(const Limbs &words);
+
+}  // namespace bitwise
+
+}  // namespace big_num_arithmetic
+
+#endif  // BITWISE_H_
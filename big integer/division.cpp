@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <cmath>
+#include "division.h"
+#include "multiplication.h"
+
+namespace big_num_arithmetic {
+
+namespace division {
+
+using magnitude::Limb;
+using magnitude::Wide;
+using magnitude::Add;
+using magnitude::Compare;
+using magnitude::Slice;
+using magnitude::Sub;
+using multiplication::Multiply;
+
+namespace {
+
+    // base^exponent
+    Limbs Power(size_t exponent) {
+        Limbs res(exponent + 1, 0);
+        res.back() = 1;
+        return res;
+    }
+
+    // a * base^k
+    Limbs ShiftLimbs(const Limbs &a, size_t k) {
+        if (a.empty()) {
+            return {};
+        }
+        Limbs res(k, 0);
+        res.insert(res.end(), a.begin(), a.end());
+        return res;
+    }
+
+    // Single-limb division or Algorithm D, both operands trimmed.
+    void DivModBasic(const Limbs &u, const Limbs &v, const Radix &radix,
+                     Limbs &quotient, Limbs &remainder) {
+        if (Compare(u, v) < 0) {
+            quotient.clear();
+            remainder = u;
+        } else if (v.size() == 1) {
+            Limbs q(u);
+            uint64_t rem = magnitude::DivideBySmall(q, v[0], radix);
+            quotient = q;
+            remainder = (rem ? Limbs{Limb(rem)} : Limbs{});
+        } else {
+            DivModKnuth(u, v, radix, quotient, remainder);
+        }
+    }
+
+}  // namespace
+
+    void DivMod(const Limbs &lhs, const Limbs &rhs, const Radix &radix,
+                Limbs &quotient, Limbs &remainder) {
+        Limbs u(lhs);
+        Limbs v(rhs);
+        magnitude::Trim(u);
+        magnitude::Trim(v);
+
+        if (v.size() >= kNewtonThreshold &&
+            u.size() >= v.size() + kNewtonThreshold) {
+            ReciprocalDivisor(v, radix).DivMod(u, quotient, remainder);
+        } else {
+            DivModBasic(u, v, radix, quotient, remainder);
+        }
+    }
+
+    void DivModKnuth(const Limbs &lhs, const Limbs &rhs, const Radix &radix,
+                     Limbs &quotient, Limbs &remainder) {
+        // Normalize so that the top limb of the divisor is at least
+        // base / 2, then every estimated quotient digit is off by at
+        // most two.
+        Wide base = radix.Base();
+        Wide norm = base / (Wide(rhs.back()) + 1);
+        Limbs u(lhs);
+        Limbs v(rhs);
+        if (norm > 1) {
+            magnitude::MulSmall(u, norm, radix);
+            magnitude::MulSmall(v, norm, radix);
+        }
+
+        size_t n = v.size();
+        u.resize(lhs.size() + 1, 0);
+        size_t m = u.size() - n - 1;
+        Limbs q(m + 1, 0);
+
+        Wide v1 = v[n - 1];
+        Wide v2 = v[n - 2];
+        for (size_t j = m + 1; j-- > 0;) {
+            Wide num = Wide(u[j + n]) * base + u[j + n - 1];
+            Wide qhat = num / v1;
+            Wide rhat = num % v1;
+            while (qhat >= base || qhat * v2 > rhat * base + u[j + n - 2]) {
+                qhat--;
+                rhat += v1;
+                if (rhat >= base) {
+                    break;
+                }
+            }
+
+            // u[j .. j + n] -= qhat * v
+            Wide carry = 0;
+            int64_t borrow = 0;
+            for (size_t i = 0; i < n; i++) {
+                Wide p = qhat * v[i] + carry;
+                carry = radix.High(p);
+                int64_t cur = int64_t(u[i + j]) - radix.Low(p) - borrow;
+                borrow = (cur < 0);
+                u[i + j] = Limb(borrow ? cur + int64_t(base) : cur);
+            }
+            int64_t top = int64_t(u[j + n]) - int64_t(carry) - borrow;
+
+            // The estimate was one too large, add the divisor back.
+            if (top < 0) {
+                qhat--;
+                carry = 0;
+                for (size_t i = 0; i < n; i++) {
+                    Wide cur = Wide(u[i + j]) + v[i] + carry;
+                    carry = (cur >= base);
+                    u[i + j] = Limb(carry ? cur - base : cur);
+                }
+                top += int64_t(carry);
+            }
+            u[j + n] = Limb(top);
+            q[j] = Limb(qhat);
+        }
+
+        magnitude::Trim(q);
+        u.resize(n);
+        magnitude::Trim(u);
+        if (norm > 1) {
+            magnitude::DivideBySmall(u, norm, radix);
+        }
+
+        quotient = q;
+        remainder = u;
+    }
+
+    Limbs Reciprocal(const Limbs &divisor, const Radix &radix) {
+        size_t n = divisor.size();
+        Limbs pow = Power(2 * n);
+        Limbs q, r;
+        if (n < kNewtonThreshold) {
+            DivModBasic(pow, divisor, radix, q, r);
+            return q;
+        }
+
+        // The reciprocal of the top half (plus a guard limb) is accurate
+        // to about n / 2 limbs, one Newton step doubles that:
+        // x = 2x - floor(divisor * x^2 / base^(2n)).
+        size_t k = n / 2 + 1;
+        Limbs x = ShiftLimbs(Reciprocal(Slice(divisor, n - k, k), radix),
+                             n - k);
+        Limbs x_sqr_d = Multiply(Multiply(divisor, x, radix), x, radix);
+        Limbs correction = Slice(x_sqr_d, 2 * n, x_sqr_d.size());
+        Limbs twice_x = Add(x, x, radix);
+        x = (Compare(twice_x, correction) > 0
+                ? Sub(twice_x, correction, radix) : Limbs{});
+
+        // Now x is off by a few units, fix it with the exact remainder.
+        Limbs dx = Multiply(divisor, x, radix);
+        if (Compare(dx, pow) <= 0) {
+            DivModBasic(Sub(pow, dx, radix), divisor, radix, q, r);
+            x = Add(x, q, radix);
+        } else {
+            DivModBasic(Sub(dx, pow, radix), divisor, radix, q, r);
+            if (!r.empty()) {
+                q = Add(q, Limbs{1}, radix);
+            }
+            x = Sub(x, q, radix);
+        }
+        return x;
+    }
+
+    Limbs ISqrt(const Limbs &a, const Radix &radix, bool &exact) {
+        Limbs n(a);
+        magnitude::Trim(n);
+        if (n.size() <= 2) {
+            uint64_t value = magnitude::ToWord(n, radix);
+            long double approx = std::sqrt((long double)value);
+            uint64_t root = uint64_t(approx);
+            while (magnitude::DoubleWide(root) * root > value) {
+                root--;
+            }
+            while (magnitude::DoubleWide(root + 1) * (root + 1) <= value) {
+                root++;
+            }
+            exact = (root * root == value);
+            return magnitude::FromWord(root, radix);
+        }
+
+        // (sqrt(top) + 1) * base^k is above the root and already has
+        // about half of its limbs right.
+        size_t k = std::max<size_t>(n.size() / 4, 1);
+        bool top_exact;
+        Limbs x = ISqrt(Slice(n, 2 * k, n.size()), radix, top_exact);
+        magnitude::AddWord(x, 1, radix);
+        x = ShiftLimbs(x, k);
+
+        // Descends to the root: x = (x + n / x) / 2 until it stops
+        // decreasing.
+        Limbs q, r;
+        while (true) {
+            DivMod(n, x, radix, q, r);
+            if (Compare(q, x) >= 0) {
+                exact = (Compare(q, x) == 0 && r.empty());
+                return x;
+            }
+            Limbs next = Add(x, q, radix);
+            magnitude::DivideBySmall(next, 2, radix);
+            magnitude::Trim(next);
+            x = std::move(next);
+        }
+    }
+
+    ReciprocalDivisor::ReciprocalDivisor(const Limbs &divisor,
+                                         const Radix &radix)
+            : divisor(divisor),
+              radix(radix) {
+        magnitude::Trim(this->divisor);
+        reciprocal = Reciprocal(this->divisor, radix);
+    }
+
+    const Limbs &ReciprocalDivisor::Divisor() const {
+        return divisor;
+    }
+
+    void ReciprocalDivisor::DivMod(const Limbs &lhs, Limbs &quotient,
+                                   Limbs &remainder) const {
+        Limbs u(lhs);
+        magnitude::Trim(u);
+
+        size_t n = divisor.size();
+        if (u.size() <= 2 * n) {
+            DivModShort(u, quotient, remainder);
+            return;
+        }
+
+        // Long division with base^n digits, every partial dividend is
+        // below divisor * base^n.
+        Limbs q(u.size(), 0);
+        Limbs rem;
+        for (size_t chunk = (u.size() + n - 1) / n; chunk-- > 0;) {
+            size_t from = chunk * n;
+            Limbs cur = ShiftLimbs(rem, n);
+            magnitude::AddShifted(cur, Slice(u, from, n), 0, radix);
+            magnitude::Trim(cur);
+
+            Limbs digit;
+            DivModShort(cur, digit, rem);
+            std::copy(digit.begin(), digit.end(), q.begin() + from);
+        }
+        magnitude::Trim(q);
+
+        quotient = q;
+        remainder = rem;
+    }
+
+    void ReciprocalDivisor::DivModShort(const Limbs &lhs, Limbs &quotient,
+                                        Limbs &remainder) const {
+        // floor(lhs * reciprocal / base^(2n)) is at most two below the
+        // quotient.
+        size_t n = divisor.size();
+        Limbs prod = Multiply(lhs, reciprocal, radix);
+        Limbs q = Slice(prod, 2 * n, prod.size());
+        Limbs r = Sub(lhs, Multiply(q, divisor, radix), radix);
+        while (Compare(r, divisor) >= 0) {
+            r = Sub(r, divisor, radix);
+            q = Add(q, Limbs{1}, radix);
+        }
+
+        quotient = q;
+        remainder = r;
+    }
+
+}  // namespace division
+
+}  // namespace big_num_arithmetic
@@ -0,0 +1,59 @@
+#ifndef DIVISION_H_
+#define DIVISION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include "magnitude.h"
+
+namespace big_num_arithmetic {
+
+namespace division {
+
+using Limbs = magnitude::Limbs;
+using magnitude::Radix;
+
+// Divisors and quotients with at least this many limbs are divided with
+// a Newton reciprocal instead of Algorithm D.
+constexpr size_t kNewtonThreshold = 1'500;
+
+// lhs = quotient * rhs + remainder, rhs must be non-zero.
+void DivMod(const Limbs &lhs, const Limbs &rhs, const Radix &radix,
+            Limbs &quotient, Limbs &remainder);
+
+// Knuth's Algorithm D, rhs must have at least two limbs.
+void DivModKnuth(const Limbs &lhs, const Limbs &rhs, const Radix &radix,
+                 Limbs &quotient, Limbs &remainder);
+
+// floor(base^(2n) / divisor) for a divisor of n limbs, computed with
+// Newton's iteration.
+Limbs Reciprocal(const Limbs &divisor, const Radix &radix);
+
+// floor(sqrt(a)), exact tells whether a is a perfect square. The root of
+// the top half of a seeds Newton's iteration, which then needs only a
+// couple of steps.
+Limbs ISqrt(const Limbs &a, const Radix &radix, bool &exact);
+
+// Barrett division by a fixed divisor, the reciprocal is computed once.
+class ReciprocalDivisor {
+ public:
+    ReciprocalDivisor(const Limbs &divisor, const Radix &radix);
+
+    void DivMod(const Limbs &lhs, Limbs &quotient, Limbs &remainder) const;
+
+    const Limbs &Divisor() const;
+
+ private:
+    Limbs divisor;
+    Limbs reciprocal;
+    Radix radix;
+
+    // Requires lhs < base^(2n).
+    void DivModShort(const Limbs &lhs, Limbs &quotient,
+                     Limbs &remainder) const;
+};
+
+}  // namespace division
+
+}  // namespace big_num_arithmetic
+
+#endif  // DIVISION_H_
@@ -1,79 +1,179 @@
-//
-// Created by Computer on 29.10.2019.
-//
-
-#include <stdexcept>
-#include "equation_solver.h"
-#include "big_integer.h"
-
-using big_num_arithmetic::BigInteger;
-
-namespace equation_solver {
-
-bool Solve(const QuadraticEquation &equation,
-                BigInteger &x1,
-                BigInteger &x2) {
-    const BigInteger &a = equation.a,
-                     &c = equation.c,
-                     &b = equation.b;
-    BigInteger D = (b * b) - (a * 4);
-
-    if (D < 0) {
-        return false;
-    }
-
-    BigInteger sqrt_d = helpers::Sqrt(D),
-               mins_b = b * (-1),
-               two_a  = a * 2;
-
-    BigInteger x1_cur = (mins_b + sqrt_d) / two_a,
-               x2_cur = (mins_b - sqrt_d) / two_a;
-
-    return (x1 == x1_cur && x2 == x2_cur) ||
-           (x1 == x2_cur && x2 == x1_cur);
-}
-
-namespace helpers {
-
-BigInteger Sqrt(const BigInteger &val) {
-    if (val < 0) {
-        throw std::runtime_error("Bad value");
-    }
-
-    BigInteger r(val);
-    BigInteger l;
-    BigInteger x;
-
-    while (l <= r) {
-        BigInteger m = (l + r) / 2;
-        x = m * m;
-
-        if (x == val) {
-            return m;
-        } else if (x < val) {
-            l = m + 1;
-        } else {
-            r = m - 1;
-        }
-    }
-
-    return BigInteger(0);
-}
-
-}  // namespace helpers
-
-namespace big_num_arithmetic {
-
-QuadraticEquation
-GenerateEquation(const BigInteger &a,
-                 const BigInteger &x1,
-                 const BigInteger &x2) {
-    BigInteger b = a * (x1 + x2) * (-1),
-               c = a * x1 * x2;
-    return {a, b, c};
-}
-
-}  // namespace big_num_arithmetic
-
-}  // namespace equation_solver
-
+//
+// Created by Computer on 29.10.2019.
+//
+
+#include "equation_solver.h"
+#include "big_integer.h"
+
+using big_num_arithmetic::BigInteger;
+
+namespace equation_solver {
+
+bool Solve(const QuadraticEquation &equation,
+                BigInteger &x1,
+                BigInteger &x2) {
+    const BigInteger &a = equation.a,
+                     &c = equation.c,
+                     &b = equation.b;
+    BigInteger D = b * b;
+    BigInteger::SubMul(D, a * 4, c);
+
+    if (D < 0) {
+        return false;
+    }
+
+    // Integer roots need a perfect square discriminant.
+    bool exact;
+    BigInteger sqrt_d = BigInteger::ISqrt(D, exact);
+    if (!exact) {
+        return false;
+    }
+
+    BigInteger mins_b = b * (-1),
+               two_a  = a * 2;
+
+    // Both roots are integers only if 2a divides their numerators.
+    BigInteger num1 = mins_b + sqrt_d,
+               num2 = mins_b - sqrt_d;
+    if (num1 % two_a != 0 || num2 % two_a != 0) {
+        return false;
+    }
+
+    BigInteger x1_cur = num1 / two_a,
+               x2_cur = num2 / two_a;
+
+    return (x1 == x1_cur && x2 == x2_cur) ||
+           (x1 == x2_cur && x2 == x1_cur);
+}
+
+Bitmap::Bitmap(size_t size)
+        : size(size),
+          words((size + 63) / 64, 0) {}
+
+size_t Bitmap::Size() const {
+    return size;
+}
+
+bool Bitmap::Test(size_t i) const {
+    return (words[i / 64] >> (i % 64)) & 1;
+}
+
+size_t Bitmap::Count() const {
+    size_t count = 0;
+    for (uint64_t word : words) {
+        count += __builtin_popcountll(word);
+    }
+    return count;
+}
+
+void Bitmap::Set(size_t i, bool value) {
+    uint64_t bit = uint64_t(1) << (i % 64);
+    words[i / 64] = (value ? words[i / 64] | bit : words[i / 64] & ~bit);
+}
+
+const std::vector<uint64_t> &Bitmap::Words() const {
+    return words;
+}
+
+namespace {
+
+// Numbers reused by one worker from equation to equation, they keep
+// their limb storage between assignments.
+struct alignas(64) Scratch {
+    BigInteger sum;
+    BigInteger product;
+};
+
+// The largest prime below 2^32.
+constexpr uint32_t kResidueModulus = 4'294'967'291u;
+
+// Vieta's relations a * (x1 + x2) == -b and a * x1 * x2 == c, the
+// cheapest test first.
+bool Verify(const QuadraticEquation &eq,
+            const BigInteger &x1,
+            const BigInteger &x2,
+            Scratch &s) {
+    if (eq.a == 0) {
+        return false;
+    }
+
+    // Both relations modulo a word prime, wrong roots almost always
+    // fail here in linear time.
+    uint64_t p = kResidueModulus;
+    uint64_t a = eq.a % kResidueModulus,
+             b = eq.b % kResidueModulus,
+             c = eq.c % kResidueModulus,
+             r1 = x1 % kResidueModulus,
+             r2 = x2 % kResidueModulus;
+    if ((a * ((r1 + r2) % p) + b) % p != 0 ||
+        a * (r1 * r2 % p) % p != c) {
+        return false;
+    }
+
+    s.sum = x1;
+    s.sum += x2;
+    s.sum *= eq.a;
+    s.sum += eq.b;
+    if (s.sum != 0) {
+        return false;
+    }
+
+    s.product = x1;
+    s.product *= x2;
+    s.product *= eq.a;
+    return s.product == eq.c;
+}
+
+// Chunks are whole words of the bitmap, so workers never write to the
+// same word.
+constexpr size_t kBatchGrain = 256;
+
+}  // namespace
+
+bool Verify(const QuadraticEquation &equation,
+            const BigInteger &x1,
+            const BigInteger &x2) {
+    Scratch scratch;
+    return Verify(equation, x1, x2, scratch);
+}
+
+Bitmap VerifyBatch(const QuadraticEquation *equations,
+                   const QuadraticRoots *roots,
+                   size_t count,
+                   ThreadPool &pool) {
+    Bitmap result(count);
+    std::vector<Scratch> scratch(pool.Size());
+
+    pool.ParallelFor(count, kBatchGrain,
+                     [&](size_t begin, size_t end, size_t worker) {
+        for (size_t i = begin; i < end; i++) {
+            result.Set(i, Verify(equations[i], roots[i].x1, roots[i].x2,
+                                 scratch[worker]));
+        }
+    });
+    return result;
+}
+
+Bitmap VerifyBatch(const QuadraticEquation *equations,
+                   const QuadraticRoots *roots,
+                   size_t count,
+                   size_t threads) {
+    ThreadPool pool(threads);
+    return VerifyBatch(equations, roots, count, pool);
+}
+
+namespace big_num_arithmetic {
+
+QuadraticEquation
+GenerateEquation(const BigInteger &a,
+                 const BigInteger &x1,
+                 const BigInteger &x2) {
+    BigInteger b = a * (x1 + x2) * (-1),
+               c = a * x1 * x2;
+    return {a, b, c};
+}
+
+}  // namespace big_num_arithmetic
+
+}  // namespace equation_solver
+
@@ -1,37 +1,87 @@
-//
-// Created by Computer on 29.10.2019.
-//
-
-#ifndef EQUATION_SOLVER_H_
-#define EQUATION_SOLVER_H_
-
-#include "big_integer.h"
-
-using big_num_arithmetic::BigInteger;
-
-namespace equation_solver {
-
-struct QuadraticEquation {
-    BigInteger a;
-    BigInteger b;
-    BigInteger c;
-};
-
-bool Solve(const QuadraticEquation &equation,
-            BigInteger &x1,
-            BigInteger &x2);
-
-namespace helpers {
-    BigInteger Sqrt(const BigInteger &val);
-}  // namespace helpers
-
-namespace big_num_arithmetic {
-    QuadraticEquation
-        GenerateEquation(const BigInteger& a,
-                         const BigInteger& x1,
-                         const BigInteger& x2);
-}  // namespace big_num_arithmetic
-
-}  // namespace equation_solver
-
-#endif  // EQUATION_SOLVER_H_
+//
+// Created by Computer on 29.10.2019.
+//
+
+#ifndef EQUATION_SOLVER_H_
+#define EQUATION_SOLVER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "big_integer.h"
+#include "thread_pool.h"
+
+using big_num_arithmetic::BigInteger;
+using big_num_arithmetic::ThreadPool;
+
+namespace equation_solver {
+
+struct QuadraticEquation {
+    BigInteger a;
+    BigInteger b;
+    BigInteger c;
+};
+
+bool Solve(const QuadraticEquation &equation,
+            BigInteger &x1,
+            BigInteger &x2);
+
+// Checks given roots without computing any, through the exact Vieta
+// relations a * (x1 + x2) == -b and a * x1 * x2 == c, which hold
+// exactly when Solve would accept them, except that a == 0 gives false
+// instead of throwing. No square root or division is needed, and most
+// wrong roots are rejected before multiplying.
+bool Verify(const QuadraticEquation &equation,
+            const BigInteger &x1,
+            const BigInteger &x2);
+
+struct QuadraticRoots {
+    BigInteger x1;
+    BigInteger x2;
+};
+
+// One bit per equation of a batch.
+class Bitmap {
+ public:
+    explicit Bitmap(size_t size = 0);
+
+    size_t Size() const;
+    bool Test(size_t i) const;
+    // Number of set bits.
+    size_t Count() const;
+
+    void Set(size_t i, bool value);
+
+    // Bits 64 * i to 64 * i + 63 of the map.
+    const std::vector<uint64_t> &Words() const;
+
+ private:
+    size_t size;
+    std::vector<uint64_t> words;
+};
+
+// Verifies given roots of a batch of equations, bit i is
+// Verify(equations[i], roots[i].x1, roots[i].x2). The batch is spread
+// over the pool and each worker reuses its own scratch numbers, so
+// equations of a few limbs never allocate.
+Bitmap VerifyBatch(const QuadraticEquation *equations,
+                   const QuadraticRoots *roots,
+                   size_t count,
+                   ThreadPool &pool);
+// Runs on a temporary pool of threads workers, 0 picks the hardware
+// concurrency.
+Bitmap VerifyBatch(const QuadraticEquation *equations,
+                   const QuadraticRoots *roots,
+                   size_t count,
+                   size_t threads = 0);
+
+namespace big_num_arithmetic {
+    QuadraticEquation
+        GenerateEquation(const BigInteger& a,
+                         const BigInteger& x1,
+                         const BigInteger& x2);
+}  // namespace big_num_arithmetic
+
+}  // namespace equation_solver
+
+#endif  // EQUATION_SOLVER_H_
@@ -0,0 +1,115 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "equation_solver.h"
+
+using equation_solver::QuadraticEquation;
+using equation_solver::QuadraticRoots;
+
+namespace {
+
+BigInteger GenInteger(int digits, std::mt19937 &mt) {
+    std::uniform_int_distribution<int> dist(0, 9);
+    std::string str(1, char('1' + dist(mt) % 9));
+    for (int i = 1; i < digits; i++) {
+        str += char('0' + dist(mt));
+    }
+    if (dist(mt) % 2) {
+        str = "-" + str;
+    }
+    return BigInteger::FromString(str, 10);
+}
+
+// Equations per second of one call, repeated for at least 200 ms.
+template <typename Function>
+double Measure(size_t count, Function function) {
+    using Clock = std::chrono::steady_clock;
+
+    int runs = 0;
+    Clock::duration total{};
+    while (runs < 3 || total < std::chrono::milliseconds(200)) {
+        auto start = Clock::now();
+        function();
+        total += Clock::now() - start;
+        runs++;
+    }
+    return count * runs / std::chrono::duration<double>(total).count();
+}
+
+}  // namespace
+
+// Throughput of Solve, Verify and VerifyBatch over random equations with
+// valid roots, usage: equation_solver_bench [equations] [root digits].
+int main(int argc, char **argv) {
+    size_t count = (argc > 1 ? std::stoull(argv[1]) : 100'000);
+    int digits = (argc > 2 ? std::stoi(argv[2]) : 9);
+    std::mt19937 mt(42);
+
+    std::vector<QuadraticEquation> equations;
+    std::vector<QuadraticRoots> roots;
+    for (size_t i = 0; i < count; i++) {
+        BigInteger a = GenInteger(digits, mt);
+        BigInteger x1 = GenInteger(digits, mt);
+        BigInteger x2 = GenInteger(digits, mt);
+        equations.push_back(
+                equation_solver::big_num_arithmetic::GenerateEquation(
+                        a, x1, x2));
+        roots.push_back({x1, x2});
+    }
+
+    std::cout << std::setw(16) << "mode"
+              << std::setw(20) << "equations/s" << std::endl;
+
+    double solve = Measure(count, [&] {
+        for (size_t i = 0; i < count; i++) {
+            equation_solver::Solve(equations[i], roots[i].x1, roots[i].x2);
+        }
+    });
+    std::cout << std::setw(16) << "Solve"
+              << std::setw(20) << std::fixed << std::setprecision(0)
+              << solve << std::endl;
+
+    // The temporaries of a whole pass come from one arena, which is
+    // then released at once.
+    std::pmr::monotonic_buffer_resource arena;
+    double solve_arena = Measure(count, [&] {
+        {
+            big_num_arithmetic::ScopedMemoryResource scope(&arena);
+            for (size_t i = 0; i < count; i++) {
+                equation_solver::Solve(equations[i], roots[i].x1,
+                                       roots[i].x2);
+            }
+        }
+        arena.release();
+    });
+    std::cout << std::setw(16) << "Solve, arena" << std::setw(20)
+              << solve_arena << std::endl;
+
+    double verify = Measure(count, [&] {
+        for (size_t i = 0; i < count; i++) {
+            equation_solver::Verify(equations[i], roots[i].x1, roots[i].x2);
+        }
+    });
+    std::cout << std::setw(16) << "Verify" << std::setw(20) << verify
+              << std::endl;
+
+    size_t max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        ThreadPool pool(threads);
+        double batch = Measure(count, [&] {
+            equation_solver::VerifyBatch(equations.data(), roots.data(),
+                                         count, pool);
+        });
+        std::cout << std::setw(16)
+                  << "VerifyBatch x" + std::to_string(threads)
+                  << std::setw(20) << batch << std::endl;
+    }
+    return 0;
+}
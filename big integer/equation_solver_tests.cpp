@@ -1,51 +1,153 @@
-//
-// Created by ZenBook on 05.11.2019.
-//
-
-#include "equation_solver.h"
-#include <gtest.h>
-#include <random>
-#include "big_integer.h"
-
-using big_num_arithmetic::BigInteger;
-
-BigInteger GenBInteger() {
-    std::random_device rd;
-    std::mt19937 mt(rd());
-    std::uniform_int_distribution<uint32_t> dist(INT32_MIN, INT32_MAX);
-    int64_t num = 0;
-    while (!num) {
-        num = dist(mt);
-    }
-    return BigInteger(num);
-}
-
-namespace equation_solver {
-
-    TEST(EqSolverTests, Sqrt) {
-        for (int i = 2; i <= 10000; i++) {
-            BigInteger::SetInternalBase(i);
-            for (int j = 0; j < 100; j++) {
-                EXPECT_EQ(helpers::Sqrt(BigInteger(i*i)), i);
-            }
-        }
-    }
-
-    TEST(EqSolverTests, QuadraticEquations) {
-        for (int x = 2; x <= 10; x++) {
-            std::cout << "start " << x << std::endl;
-            int q = 1'000;
-            while (q--) {
-                BigInteger a(GenBInteger()),
-                        x1(GenBInteger()),
-                        x2(GenBInteger());
-                QuadraticEquation eq =
-                        big_num_arithmetic::GenerateEquation(a, x1, x2);
-
-                EXPECT_TRUE(Solve(eq, x1, x2));
-            }
-        }
-    }
-
-}  // namespace equation_solver
-
+//
+// Created by ZenBook on 05.11.2019.
+//
+
+#include "equation_solver.h"
+#include <gtest.h>
+#include <random>
+#include "big_integer.h"
+
+using big_num_arithmetic::BigInteger;
+
+BigInteger GenBInteger() {
+    std::random_device rd;
+    std::mt19937 mt(rd());
+    std::uniform_int_distribution<uint32_t> dist(INT32_MIN, INT32_MAX);
+    int64_t num = 0;
+    while (!num) {
+        num = dist(mt);
+    }
+    return BigInteger(num);
+}
+
+namespace equation_solver {
+
+    TEST(EqSolverTests, Sqrt) {
+        for (int i = 2; i <= 10000; i++) {
+            for (int j = 0; j < 100; j++) {
+                // i*i + k stays below (i + 1)^2.
+                int k = j % (2 * i + 1);
+                bool exact;
+                EXPECT_EQ(BigInteger::ISqrt(BigInteger(i*i + k), exact), i);
+                EXPECT_EQ(exact, k == 0);
+            }
+        }
+        EXPECT_EQ(BigInteger::ISqrt(BigInteger(0)), 0);
+        EXPECT_THROW(BigInteger::ISqrt(BigInteger(-1)), std::runtime_error);
+    }
+
+    TEST(EqSolverTests, LargeSqrt) {
+        BigInteger x = BigInteger::FromString(std::string(3'000, '7'), 10);
+        for (int64_t d : {-1, 0, 1}) {
+            BigInteger root = x + BigInteger(d);
+            bool exact;
+            EXPECT_EQ(BigInteger::ISqrt(root * root, exact), root);
+            EXPECT_TRUE(exact);
+            EXPECT_EQ(BigInteger::ISqrt(root * root - BigInteger(1), exact),
+                      root - BigInteger(1));
+            EXPECT_FALSE(exact);
+            EXPECT_EQ(BigInteger::ISqrt(root * root + root * 2, exact), root);
+            EXPECT_FALSE(exact);
+        }
+
+        using Decimal = ::big_num_arithmetic::BasicBigInteger<uint32_t, 10>;
+        Decimal y = Decimal::FromString(std::string(500, '3'), 10);
+        bool exact;
+        EXPECT_EQ(Decimal::ISqrt(y * y, exact), y);
+        EXPECT_TRUE(exact);
+        EXPECT_EQ(Decimal::ISqrt(y * y + y, exact), y);
+        EXPECT_FALSE(exact);
+    }
+
+    TEST(EqSolverTests, QuadraticEquations) {
+        for (int x = 2; x <= 10; x++) {
+            std::cout << "start " << x << std::endl;
+            int q = 1'000;
+            while (q--) {
+                BigInteger a(GenBInteger()),
+                        x1(GenBInteger()),
+                        x2(GenBInteger());
+                QuadraticEquation eq =
+                        big_num_arithmetic::GenerateEquation(a, x1, x2);
+
+                EXPECT_TRUE(Solve(eq, x1, x2));
+            }
+        }
+    }
+
+    TEST(EqSolverTests, Verify) {
+        for (int q = 0; q < 1'000; q++) {
+            BigInteger a(GenBInteger()),
+                    x1(GenBInteger()),
+                    x2(GenBInteger());
+            QuadraticEquation eq =
+                    big_num_arithmetic::GenerateEquation(a, x1, x2);
+
+            EXPECT_TRUE(Verify(eq, x1, x2));
+            EXPECT_TRUE(Verify(eq, x2, x1));
+            EXPECT_FALSE(Verify(eq, x1 + BigInteger(1), x2));
+            EXPECT_FALSE(Verify(eq, x1, x2 * 2));
+            EXPECT_FALSE(Verify(eq, x1 * -1, x2 * -1));
+        }
+
+        // Residues match modulo the word prime, the exact check fails.
+        BigInteger p(4'294'967'291);
+        QuadraticEquation eq = big_num_arithmetic::GenerateEquation(
+                BigInteger(3), BigInteger(5), BigInteger(-7));
+        EXPECT_FALSE(Verify(eq, BigInteger(5) + p, BigInteger(-7) - p));
+        EXPECT_FALSE(Verify(eq, BigInteger(5) + p, BigInteger(-7)));
+
+        BigInteger big = BigInteger::FromString(std::string(400, '8'), 10);
+        eq = big_num_arithmetic::GenerateEquation(big, big * -3, big + big);
+        EXPECT_TRUE(Verify(eq, big + big, big * -3));
+        EXPECT_FALSE(Verify(eq, big + big, big * 3));
+
+        EXPECT_FALSE(Verify({BigInteger(0), BigInteger(0), BigInteger(0)},
+                            BigInteger(0), BigInteger(0)));
+
+        // The roots are 1 and 1/2, so 0 is not one of them.
+        QuadraticEquation half{BigInteger(2), BigInteger(-3), BigInteger(1)};
+        BigInteger one(1), zero(0);
+        EXPECT_FALSE(Solve(half, one, zero));
+        EXPECT_FALSE(Verify(half, one, zero));
+    }
+
+    TEST(EqSolverTests, VerifyBatch) {
+        std::vector<QuadraticEquation> equations;
+        std::vector<QuadraticRoots> roots;
+        for (int i = 0; i < 2'000; i++) {
+            BigInteger a(GenBInteger()),
+                    x1(GenBInteger()),
+                    x2(GenBInteger());
+            equations.push_back(
+                    big_num_arithmetic::GenerateEquation(a, x1, x2));
+            if (i % 3 == 1) {
+                x1 += BigInteger(1);
+            } else if (i % 3 == 2) {
+                std::swap(x1, x2);
+            }
+            roots.push_back({x1, x2});
+        }
+        // Not a square discriminant and not a quadratic.
+        equations.push_back({BigInteger(1), BigInteger(1), BigInteger(1)});
+        roots.push_back({BigInteger(0), BigInteger(0)});
+        equations.push_back({BigInteger(0), BigInteger(0), BigInteger(0)});
+        roots.push_back({BigInteger(0), BigInteger(0)});
+
+        for (size_t threads : {1, 4}) {
+            Bitmap result = VerifyBatch(equations.data(), roots.data(),
+                                        equations.size(), threads);
+            ASSERT_EQ(result.Size(), equations.size());
+            for (size_t i = 0; i + 2 < equations.size(); i++) {
+                EXPECT_EQ(result.Test(i),
+                          Solve(equations[i], roots[i].x1, roots[i].x2));
+                EXPECT_EQ(result.Test(i), i % 3 != 1);
+            }
+            EXPECT_FALSE(result.Test(equations.size() - 2));
+            EXPECT_FALSE(result.Test(equations.size() - 1));
+            EXPECT_EQ(result.Count(), 1'333u);
+        }
+    }
+
+}  // namespace equation_solver
+
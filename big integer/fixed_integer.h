@@ -0,0 +1,677 @@
+#ifndef FIXED_INTEGER_H_
+#define FIXED_INTEGER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include "big_integer.h"
+
+namespace big_num_arithmetic {
+
+// A Bits wide two's complement integer in a std::array of binary words,
+// without heap storage, a size or a sign field. Arithmetic wraps modulo
+// 2^Bits like the built-in types, division truncates like BigInteger.
+// The limb loops are the schoolbook and Knuth ones of BigInteger over a
+// compile-time number of words, so they unroll, and they are constexpr.
+template<size_t Bits>
+class FixedInteger {
+    static_assert(Bits % 32 == 0 && Bits >= 64,
+                  "Bits must be a multiple of 32, at least 64");
+
+ public:
+    using Limb = magnitude::Limb;
+    static constexpr size_t kWords = Bits / 32;
+    // Little endian.
+    using Words = std::array<Limb, kWords>;
+
+    constexpr FixedInteger();
+    explicit constexpr FixedInteger(int64_t integer);
+    explicit constexpr FixedInteger(const Words &words);
+
+    // The low Bits bits of the two's complement form of value.
+    template<typename BigLimb, int64_t Base>
+    explicit FixedInteger(const BasicBigInteger<BigLimb, Base> &value);
+    template<typename BigLimb, int64_t Base>
+    explicit operator BasicBigInteger<BigLimb, Base>() const;
+
+    static constexpr FixedInteger Min();
+    static constexpr FixedInteger Max();
+
+    constexpr const Words &GetWords() const;
+    constexpr int Sign() const;
+    constexpr void Abs();
+    constexpr void Negate();
+
+    std::string ToString(int base) const;
+
+    // Compare operators
+    constexpr bool operator==(const FixedInteger &) const;
+    constexpr bool operator!=(const FixedInteger &) const;
+    constexpr bool operator> (const FixedInteger &) const;
+    constexpr bool operator< (const FixedInteger &) const;
+    constexpr bool operator>=(const FixedInteger &) const;
+    constexpr bool operator<=(const FixedInteger &) const;
+
+    // Arithmetic operators
+    constexpr FixedInteger &operator+=(const FixedInteger &);
+    constexpr FixedInteger &operator-=(const FixedInteger &);
+    constexpr FixedInteger &operator*=(const FixedInteger &);
+    constexpr FixedInteger &operator/=(const FixedInteger &);
+    // The remainder takes the sign of the dividend.
+    constexpr FixedInteger &operator%=(const FixedInteger &);
+
+    constexpr FixedInteger operator+(const FixedInteger &) const;
+    constexpr FixedInteger operator-(const FixedInteger &) const;
+    constexpr FixedInteger operator*(const FixedInteger &) const;
+    constexpr FixedInteger operator/(const FixedInteger &) const;
+    constexpr FixedInteger operator%(const FixedInteger &) const;
+    constexpr FixedInteger operator-() const;
+
+    constexpr FixedInteger &operator++();
+    constexpr FixedInteger operator++(int);
+    constexpr FixedInteger &operator--();
+    constexpr FixedInteger operator--(int);
+
+    // Bitwise operators, x >> k rounds toward minus infinity.
+    constexpr FixedInteger operator~() const;
+    constexpr FixedInteger &operator&=(const FixedInteger &);
+    constexpr FixedInteger &operator|=(const FixedInteger &);
+    constexpr FixedInteger &operator^=(const FixedInteger &);
+    constexpr FixedInteger operator&(const FixedInteger &) const;
+    constexpr FixedInteger operator|(const FixedInteger &) const;
+    constexpr FixedInteger operator^(const FixedInteger &) const;
+
+    constexpr FixedInteger &operator<<=(size_t bits);
+    constexpr FixedInteger &operator>>=(size_t bits);
+    constexpr FixedInteger operator<<(size_t bits) const;
+    constexpr FixedInteger operator>>(size_t bits) const;
+
+    explicit constexpr operator int64_t() const;
+
+ private:
+    using Wide = magnitude::Wide;
+
+    static constexpr Wide kBase = Wide(1) << 32;
+
+    Words words;
+
+    constexpr bool IsNegative() const;
+    constexpr int Compare(const FixedInteger &) const;
+
+    // Truncating division of the magnitudes u and v.
+    static constexpr void DivModMagnitude(const Words &u, const Words &v,
+                                          Words &quotient,
+                                          Words &remainder);
+    // Truncating division, the remainder takes the sign of lhs.
+    static constexpr void DivMod(const FixedInteger &lhs,
+                                 const FixedInteger &rhs,
+                                 FixedInteger &quotient,
+                                 FixedInteger &remainder);
+};
+
+using Int128 = FixedInteger<128>;
+using Int256 = FixedInteger<256>;
+using Int512 = FixedInteger<512>;
+using Int1024 = FixedInteger<1024>;
+using Int2048 = FixedInteger<2048>;
+using Int4096 = FixedInteger<4096>;
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits>::FixedInteger() : words{} {}
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits>::FixedInteger(int64_t integer) : words{} {
+        uint64_t value = uint64_t(integer);
+        words[0] = Limb(value);
+        words[1] = Limb(value >> 32);
+        for (size_t i = 2; i < kWords; i++) {
+            words[i] = (integer < 0 ? ~Limb(0) : 0);
+        }
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits>::FixedInteger(const Words &words)
+            : words(words) {}
+
+    template<size_t Bits>
+    template<typename BigLimb, int64_t Base>
+    FixedInteger<Bits>::FixedInteger(
+            const BasicBigInteger<BigLimb, Base> &value) : words{} {
+        // The serialized form holds the binary words of any base.
+        std::string buffer(value.SerializedSize(), '\0');
+        value.Serialize(&buffer[0]);
+        BigIntegerView view = BigIntegerView::Parse(buffer.data(),
+                                                    buffer.size());
+        for (size_t i = 0; i < kWords && i < view.Size(); i++) {
+            words[i] = view.Word(i);
+        }
+        if (view.Sign() < 0) {
+            Negate();
+        }
+    }
+
+    template<size_t Bits>
+    template<typename BigLimb, int64_t Base>
+    FixedInteger<Bits>::operator BasicBigInteger<BigLimb, Base>() const {
+        FixedInteger abs = *this;
+        abs.Abs();
+        magnitude::Limbs limbs(abs.words.begin(), abs.words.end());
+        magnitude::Trim(limbs);
+
+        std::string buffer(serialization::ByteSize(limbs.size()), '\0');
+        serialization::Write(limbs, IsNegative(), &buffer[0]);
+        return BasicBigInteger<BigLimb, Base>::Deserialize(buffer.data(),
+                                                           buffer.size());
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::Min() {
+        FixedInteger res;
+        res.words[kWords - 1] = Limb(1) << 31;
+        return res;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::Max() {
+        return ~Min();
+    }
+
+    template<size_t Bits>
+    constexpr const typename FixedInteger<Bits>::Words &
+    FixedInteger<Bits>::GetWords() const {
+        return words;
+    }
+
+    template<size_t Bits>
+    constexpr int FixedInteger<Bits>::Sign() const {
+        if (IsNegative()) {
+            return -1;
+        }
+        for (size_t i = 0; i < kWords; i++) {
+            if (words[i]) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    template<size_t Bits>
+    constexpr void FixedInteger<Bits>::Abs() {
+        if (IsNegative()) {
+            Negate();
+        }
+    }
+
+    template<size_t Bits>
+    constexpr void FixedInteger<Bits>::Negate() {
+        Wide carry = 1;
+        for (size_t i = 0; i < kWords; i++) {
+            Wide cur = Wide(Limb(~words[i])) + carry;
+            words[i] = Limb(cur);
+            carry = cur >> 32;
+        }
+    }
+
+    template<size_t Bits>
+    std::string FixedInteger<Bits>::ToString(int base) const {
+        return static_cast<BasicBigInteger<>>(*this).ToString(base);
+    }
+
+    // Compare operators
+    template<size_t Bits>
+    constexpr bool FixedInteger<Bits>::operator==(
+            const FixedInteger &rhs) const {
+        return Compare(rhs) == 0;
+    }
+
+    template<size_t Bits>
+    constexpr bool FixedInteger<Bits>::operator!=(
+            const FixedInteger &rhs) const {
+        return Compare(rhs) != 0;
+    }
+
+    template<size_t Bits>
+    constexpr bool FixedInteger<Bits>::operator>(
+            const FixedInteger &rhs) const {
+        return Compare(rhs) > 0;
+    }
+
+    template<size_t Bits>
+    constexpr bool FixedInteger<Bits>::operator<(
+            const FixedInteger &rhs) const {
+        return Compare(rhs) < 0;
+    }
+
+    template<size_t Bits>
+    constexpr bool FixedInteger<Bits>::operator>=(
+            const FixedInteger &rhs) const {
+        return Compare(rhs) >= 0;
+    }
+
+    template<size_t Bits>
+    constexpr bool FixedInteger<Bits>::operator<=(
+            const FixedInteger &rhs) const {
+        return Compare(rhs) <= 0;
+    }
+
+    // Arithmetic operators
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> &FixedInteger<Bits>::operator+=(
+            const FixedInteger &rhs) {
+        Wide carry = 0;
+        for (size_t i = 0; i < kWords; i++) {
+            Wide cur = Wide(words[i]) + rhs.words[i] + carry;
+            words[i] = Limb(cur);
+            carry = cur >> 32;
+        }
+        return *this;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> &FixedInteger<Bits>::operator-=(
+            const FixedInteger &rhs) {
+        Wide borrow = 0;
+        for (size_t i = 0; i < kWords; i++) {
+            Wide cur = Wide(words[i]) - rhs.words[i] - borrow;
+            words[i] = Limb(cur);
+            borrow = (cur >> 32) & 1;
+        }
+        return *this;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> &FixedInteger<Bits>::operator*=(
+            const FixedInteger &rhs) {
+        // The low kWords words of the schoolbook product of the
+        // magnitudes, negated back if the signs differ. Zero words of
+        // the magnitudes are skipped, so small values of either sign
+        // in wide types multiply in few steps.
+        FixedInteger lhs = *this;
+        FixedInteger mag = rhs;
+        bool negative = (lhs.IsNegative() != mag.IsNegative());
+        if (lhs.IsNegative()) {
+            lhs.Negate();
+        }
+        if (mag.IsNegative()) {
+            mag.Negate();
+        }
+        size_t rsz = kWords;
+        while (rsz && mag.words[rsz - 1] == 0) {
+            rsz--;
+        }
+        Words res{};
+        for (size_t i = 0; i < kWords; i++) {
+            Wide x = lhs.words[i];
+            if (x == 0) {
+                continue;
+            }
+            Wide carry = 0;
+            for (size_t j = 0; j < rsz && i + j < kWords; j++) {
+                Wide cur = x * mag.words[j] + res[i + j] + carry;
+                res[i + j] = Limb(cur);
+                carry = cur >> 32;
+            }
+            if (i + rsz < kWords) {
+                res[i + rsz] = Limb(carry);
+            }
+        }
+        words = res;
+        if (negative) {
+            Negate();
+        }
+        return *this;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> &FixedInteger<Bits>::operator/=(
+            const FixedInteger &rhs) {
+        FixedInteger remainder;
+        DivMod(*this, rhs, *this, remainder);
+        return *this;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> &FixedInteger<Bits>::operator%=(
+            const FixedInteger &rhs) {
+        FixedInteger quotient;
+        DivMod(*this, rhs, quotient, *this);
+        return *this;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::operator+(
+            const FixedInteger &rhs) const {
+        FixedInteger res = *this;
+        return res += rhs;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::operator-(
+            const FixedInteger &rhs) const {
+        FixedInteger res = *this;
+        return res -= rhs;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::operator*(
+            const FixedInteger &rhs) const {
+        FixedInteger res = *this;
+        return res *= rhs;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::operator/(
+            const FixedInteger &rhs) const {
+        FixedInteger quotient, remainder;
+        DivMod(*this, rhs, quotient, remainder);
+        return quotient;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::operator%(
+            const FixedInteger &rhs) const {
+        FixedInteger quotient, remainder;
+        DivMod(*this, rhs, quotient, remainder);
+        return remainder;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::operator-() const {
+        FixedInteger res = *this;
+        res.Negate();
+        return res;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> &FixedInteger<Bits>::operator++() {
+        return *this += FixedInteger(1);
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::operator++(int) {
+        FixedInteger res = *this;
+        ++*this;
+        return res;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> &FixedInteger<Bits>::operator--() {
+        return *this -= FixedInteger(1);
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::operator--(int) {
+        FixedInteger res = *this;
+        --*this;
+        return res;
+    }
+
+    // Bitwise operators
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::operator~() const {
+        FixedInteger res;
+        for (size_t i = 0; i < kWords; i++) {
+            res.words[i] = ~words[i];
+        }
+        return res;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> &FixedInteger<Bits>::operator&=(
+            const FixedInteger &rhs) {
+        for (size_t i = 0; i < kWords; i++) {
+            words[i] &= rhs.words[i];
+        }
+        return *this;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> &FixedInteger<Bits>::operator|=(
+            const FixedInteger &rhs) {
+        for (size_t i = 0; i < kWords; i++) {
+            words[i] |= rhs.words[i];
+        }
+        return *this;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> &FixedInteger<Bits>::operator^=(
+            const FixedInteger &rhs) {
+        for (size_t i = 0; i < kWords; i++) {
+            words[i] ^= rhs.words[i];
+        }
+        return *this;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::operator&(
+            const FixedInteger &rhs) const {
+        FixedInteger res = *this;
+        return res &= rhs;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::operator|(
+            const FixedInteger &rhs) const {
+        FixedInteger res = *this;
+        return res |= rhs;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::operator^(
+            const FixedInteger &rhs) const {
+        FixedInteger res = *this;
+        return res ^= rhs;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> &FixedInteger<Bits>::operator<<=(
+            size_t bits) {
+        size_t shift = (bits < Bits ? bits / 32 : kWords);
+        int rest = int(bits % 32);
+        for (size_t i = kWords; i-- > 0;) {
+            Limb high = (i >= shift ? words[i - shift] : 0);
+            Limb low = (i > shift ? words[i - shift - 1] : 0);
+            words[i] = (rest ? Limb(high << rest | low >> (32 - rest))
+                             : high);
+        }
+        return *this;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> &FixedInteger<Bits>::operator>>=(
+            size_t bits) {
+        Limb fill = (IsNegative() ? ~Limb(0) : 0);
+        size_t shift = (bits < Bits ? bits / 32 : kWords);
+        int rest = int(bits % 32);
+        for (size_t i = 0; i < kWords; i++) {
+            Limb low = (i + shift < kWords ? words[i + shift] : fill);
+            Limb high = (i + shift + 1 < kWords ? words[i + shift + 1]
+                                                : fill);
+            words[i] = (rest ? Limb(low >> rest | high << (32 - rest))
+                             : low);
+        }
+        return *this;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::operator<<(
+            size_t bits) const {
+        FixedInteger res = *this;
+        return res <<= bits;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits> FixedInteger<Bits>::operator>>(
+            size_t bits) const {
+        FixedInteger res = *this;
+        return res >>= bits;
+    }
+
+    template<size_t Bits>
+    constexpr FixedInteger<Bits>::operator int64_t() const {
+        Limb fill = ((words[1] >> 31) ? ~Limb(0) : 0);
+        for (size_t i = 2; i < kWords; i++) {
+            if (words[i] != fill) {
+                throw std::runtime_error("int64_t overflow");
+            }
+        }
+        return int64_t(uint64_t(words[1]) << 32 | words[0]);
+    }
+
+    // Private methods
+    template<size_t Bits>
+    constexpr bool FixedInteger<Bits>::IsNegative() const {
+        return words[kWords - 1] >> 31;
+    }
+
+    template<size_t Bits>
+    constexpr int FixedInteger<Bits>::Compare(
+            const FixedInteger &rhs) const {
+        if (IsNegative() != rhs.IsNegative()) {
+            return (IsNegative() ? -1 : 1);
+        }
+        for (size_t i = kWords; i-- > 0;) {
+            if (words[i] != rhs.words[i]) {
+                return (words[i] < rhs.words[i] ? -1 : 1);
+            }
+        }
+        return 0;
+    }
+
+    template<size_t Bits>
+    constexpr void FixedInteger<Bits>::DivModMagnitude(const Words &u,
+                                                       const Words &v,
+                                                       Words &quotient,
+                                                       Words &remainder) {
+        size_t n = kWords;
+        while (n && v[n - 1] == 0) {
+            n--;
+        }
+        if (n == 0) {
+            throw DivisionByZeroError();
+        }
+        size_t m = kWords;
+        while (m && u[m - 1] == 0) {
+            m--;
+        }
+
+        Words q{};
+        Words r{};
+        if (m < n) {
+            quotient = q;
+            remainder = u;
+            return;
+        }
+        if (n == 1) {
+            Wide rem = 0;
+            for (size_t i = m; i-- > 0;) {
+                Wide cur = rem << 32 | u[i];
+                q[i] = Limb(cur / v[0]);
+                rem = cur % v[0];
+            }
+            r[0] = Limb(rem);
+            quotient = q;
+            remainder = r;
+            return;
+        }
+
+        // Knuth's algorithm D as in division::DivModKnuth, normalized by
+        // a shift so that the top word of the divisor has its high bit.
+        int shift = __builtin_clz(v[n - 1]);
+        std::array<Limb, kWords> vn{};
+        std::array<Limb, kWords + 1> un{};
+        for (size_t i = 0; i < n; i++) {
+            vn[i] = Limb(v[i] << shift);
+            if (shift && i) {
+                vn[i] |= v[i - 1] >> (32 - shift);
+            }
+        }
+        for (size_t i = 0; i < m; i++) {
+            un[i] = Limb(u[i] << shift);
+            if (shift && i) {
+                un[i] |= u[i - 1] >> (32 - shift);
+            }
+        }
+        un[m] = (shift ? u[m - 1] >> (32 - shift) : 0);
+
+        Wide v1 = vn[n - 1];
+        Wide v2 = vn[n - 2];
+        for (size_t j = m - n + 1; j-- > 0;) {
+            Wide num = Wide(un[j + n]) << 32 | un[j + n - 1];
+            Wide qhat = num / v1;
+            Wide rhat = num % v1;
+            while (qhat >= kBase ||
+                   qhat * v2 > (rhat << 32 | un[j + n - 2])) {
+                qhat--;
+                rhat += v1;
+                if (rhat >= kBase) {
+                    break;
+                }
+            }
+
+            // un[j .. j + n] -= qhat * vn
+            Wide carry = 0;
+            int64_t borrow = 0;
+            for (size_t i = 0; i < n; i++) {
+                Wide p = qhat * vn[i] + carry;
+                carry = p >> 32;
+                int64_t cur = int64_t(un[i + j]) - int64_t(Limb(p)) - borrow;
+                borrow = (cur < 0);
+                un[i + j] = Limb(borrow ? cur + int64_t(kBase) : cur);
+            }
+            int64_t top = int64_t(un[j + n]) - int64_t(carry) - borrow;
+
+            // The estimate was one too large, add the divisor back.
+            if (top < 0) {
+                qhat--;
+                carry = 0;
+                for (size_t i = 0; i < n; i++) {
+                    Wide cur = Wide(un[i + j]) + vn[i] + carry;
+                    un[i + j] = Limb(cur);
+                    carry = cur >> 32;
+                }
+                top += int64_t(carry);
+            }
+            un[j + n] = Limb(top);
+            q[j] = Limb(qhat);
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            r[i] = Limb(un[i] >> shift);
+            if (shift) {
+                r[i] |= Limb(un[i + 1] << (32 - shift));
+            }
+        }
+        quotient = q;
+        remainder = r;
+    }
+
+    template<size_t Bits>
+    constexpr void FixedInteger<Bits>::DivMod(const FixedInteger &lhs,
+                                              const FixedInteger &rhs,
+                                              FixedInteger &quotient,
+                                              FixedInteger &remainder) {
+        // The magnitude of Min() is 2^(Bits - 1), which still fits the
+        // words as an unsigned number.
+        bool lhs_negative = lhs.IsNegative();
+        bool rhs_negative = rhs.IsNegative();
+        FixedInteger u = lhs;
+        FixedInteger v = rhs;
+        u.Abs();
+        v.Abs();
+
+        DivModMagnitude(u.words, v.words, quotient.words, remainder.words);
+        if (lhs_negative != rhs_negative) {
+            quotient.Negate();
+        }
+        if (lhs_negative) {
+            remainder.Negate();
+        }
+    }
+
+}  // namespace big_num_arithmetic
+
+#endif  // FIXED_INTEGER_H_
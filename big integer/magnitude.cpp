@@ -0,0 +1,262 @@
+#include <algorithm>
+#include "magnitude.h"
+#include "simd.h"
+
+namespace big_num_arithmetic {
+
+namespace magnitude {
+
+namespace {
+
+    // a[from ..] += carry, returns the carry out of the top limb.
+    Limb PropagateCarry(Limbs &a, size_t from, Limb carry,
+                        const Radix &radix) {
+        Limb top = Limb(radix.Base() - 1);
+        for (size_t i = from; carry && i < a.size(); i++) {
+            if (a[i] == top) {
+                a[i] = 0;
+            } else {
+                a[i]++;
+                carry = 0;
+            }
+        }
+        return carry;
+    }
+
+    // a[from ..] -= borrow, a must be large enough.
+    void PropagateBorrow(Limbs &a, size_t from, Limb borrow,
+                         const Radix &radix) {
+        Limb top = Limb(radix.Base() - 1);
+        for (size_t i = from; borrow; i++) {
+            if (a[i] == 0) {
+                a[i] = top;
+            } else {
+                a[i]--;
+                borrow = 0;
+            }
+        }
+    }
+
+}  // namespace
+
+    void Trim(Limbs &a) {
+        while (!a.empty() && a.back() == 0) {
+            a.pop_back();
+        }
+    }
+
+    Limbs Slice(const Limbs &a, size_t from, size_t len) {
+        if (from >= a.size()) {
+            return {};
+        }
+        size_t to = std::min(a.size(), from + len);
+        Limbs res(a.begin() + from, a.begin() + to);
+        Trim(res);
+        return res;
+    }
+
+    int Compare(const Limbs &a, const Limbs &b) {
+        if (a.size() != b.size()) {
+            return a.size() < b.size() ? -1 : 1;
+        }
+        return simd::CompareN(a.data(), b.data(), a.size());
+    }
+
+    Limbs FromWord(uint64_t value, const Radix &radix) {
+        Limbs res;
+        while (value) {
+            res.push_back(radix.Low(value));
+            value = radix.High(value);
+        }
+        return res;
+    }
+
+    Limbs Add(const Limbs &a, const Limbs &b, const Radix &radix) {
+        const Limbs &lng = (a.size() >= b.size() ? a : b);
+        const Limbs &sht = (a.size() >= b.size() ? b : a);
+        Limbs res(lng);
+        res.push_back(0);
+
+        Limb carry = simd::AddN(res.data(), lng.data(), sht.data(),
+                                sht.size(), 0, radix);
+        PropagateCarry(res, sht.size(), carry, radix);
+        Trim(res);
+        return res;
+    }
+
+    Limbs Sub(const Limbs &a, const Limbs &b, const Radix &radix) {
+        Limbs res(a);
+        SubInPlace(res, b, radix);
+        return res;
+    }
+
+    void SubInPlace(Limbs &a, const Limbs &b, const Radix &radix) {
+        Limb borrow = simd::SubN(a.data(), a.data(), b.data(), b.size(), 0,
+                                 radix);
+        PropagateBorrow(a, b.size(), borrow, radix);
+        Trim(a);
+    }
+
+    void ReverseSub(Limbs &a, const Limbs &b, const Radix &radix) {
+        if (a.size() < b.size()) {
+            a.resize(b.size(), 0);
+        }
+        simd::SubN(a.data(), b.data(), a.data(), b.size(), 0, radix);
+        Trim(a);
+    }
+
+    void AddShifted(Limbs &dst, const Limbs &src, size_t shift,
+                    const Radix &radix) {
+        if (src.empty()) {
+            return;
+        }
+        if (dst.size() < shift + src.size()) {
+            dst.resize(shift + src.size(), 0);
+        }
+
+        // With shift 0 src may be dst itself, AddN reads each limb
+        // before writing it.
+        Limb *low = dst.data() + shift;
+        Limb carry = simd::AddN(low, low, src.data(), src.size(), 0, radix);
+        if (PropagateCarry(dst, shift + src.size(), carry, radix)) {
+            dst.push_back(1);
+        }
+    }
+
+    void MulSmall(Limbs &a, uint64_t m, const Radix &radix) {
+        Wide carry = 0;
+        for (Limb &x : a) {
+            Wide cur = Wide(x) * m + carry;
+            x = radix.Low(cur);
+            carry = radix.High(cur);
+        }
+        while (carry) {
+            a.push_back(radix.Low(carry));
+            carry = radix.High(carry);
+        }
+        Trim(a);
+    }
+
+    uint64_t DivideBySmall(Limbs &a, uint64_t d, const Radix &radix) {
+        Wide base = radix.Base();
+        Wide rem = 0;
+        for (size_t i = a.size(); i-- > 0;) {
+            Wide cur = rem * base + a[i];
+            a[i] = Limb(cur / d);
+            rem = cur % d;
+        }
+        Trim(a);
+        return rem;
+    }
+
+    int CompareWord(const Limbs &a, uint64_t value, const Radix &radix) {
+        // Base 2 needs up to 64 limbs for a word.
+        Limb word[64];
+        size_t len = 0;
+        while (value) {
+            word[len++] = radix.Low(value);
+            value = radix.High(value);
+        }
+
+        if (a.size() != len) {
+            return a.size() < len ? -1 : 1;
+        }
+        for (size_t i = len; i-- > 0;) {
+            if (a[i] != word[i]) {
+                return a[i] < word[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    uint64_t ToWord(const Limbs &a, const Radix &radix) {
+        uint64_t value = 0;
+        for (size_t i = a.size(); i-- > 0;) {
+            value = value * radix.Base() + a[i];
+        }
+        return value;
+    }
+
+    void AddWord(Limbs &a, uint64_t value, const Radix &radix) {
+        Wide base = radix.Base();
+        for (size_t i = 0; value; i++) {
+            if (i == a.size()) {
+                a.push_back(0);
+            }
+            Wide cur = Wide(a[i]) + radix.Low(value);
+            value = radix.High(value) + (cur >= base);
+            a[i] = Limb(cur >= base ? cur - base : cur);
+        }
+    }
+
+    void SubWord(Limbs &a, uint64_t value, const Radix &radix) {
+        Wide base = radix.Base();
+        for (size_t i = 0; value; i++) {
+            Limb sub = radix.Low(value);
+            value = radix.High(value);
+            if (a[i] < sub) {
+                a[i] = Limb(a[i] + base - sub);
+                value++;
+            } else {
+                a[i] -= sub;
+            }
+        }
+        Trim(a);
+    }
+
+    void MulWord(Limbs &a, uint64_t m, const Radix &radix) {
+        if (m <= radix.MaxSmall()) {
+            MulSmall(a, m, radix);
+            return;
+        }
+
+        DoubleWide carry = 0;
+        for (Limb &x : a) {
+            DoubleWide cur = DoubleWide(x) * m + carry;
+            x = radix.Low(cur);
+            carry = radix.High(cur);
+        }
+        while (carry) {
+            a.push_back(radix.Low(carry));
+            carry = radix.High(carry);
+        }
+        Trim(a);
+    }
+
+    uint64_t DivideByWord(Limbs &a, uint64_t d, const Radix &radix) {
+        if (d <= radix.MaxSmall()) {
+            return DivideBySmall(a, d, radix);
+        }
+
+        DoubleWide base = radix.Base();
+        uint64_t rem = 0;
+        for (size_t i = a.size(); i-- > 0;) {
+            DoubleWide cur = rem * base + a[i];
+            a[i] = Limb(cur / d);
+            rem = uint64_t(cur % d);
+        }
+        Trim(a);
+        return rem;
+    }
+
+    uint64_t ModWord(const Limbs &a, uint64_t d, const Radix &radix) {
+        if (d <= radix.MaxSmall()) {
+            Wide base = radix.Base();
+            Wide rem = 0;
+            for (size_t i = a.size(); i-- > 0;) {
+                rem = (rem * base + a[i]) % d;
+            }
+            return rem;
+        }
+
+        DoubleWide base = radix.Base();
+        uint64_t rem = 0;
+        for (size_t i = a.size(); i-- > 0;) {
+            rem = uint64_t((rem * base + a[i]) % d);
+        }
+        return rem;
+    }
+
+}  // namespace magnitude
+
+}  // namespace big_num_arithmetic
@@ -0,0 +1,136 @@
+#ifndef MAGNITUDE_H_
+#define MAGNITUDE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "small_vector.h"
+
+namespace big_num_arithmetic {
+
+// Unsigned limb arithmetic shared by the BigInteger algorithms.
+namespace magnitude {
+
+using Limb = uint32_t;
+// Holds a product of two limbs plus two more limbs.
+using Wide = uint64_t;
+// Accumulates sums of many limb products.
+using DoubleWide = unsigned __int128;
+
+// Most numbers in practice fit into a couple of limbs, an int64_t
+// product needs four.
+constexpr size_t kInlineLimbs = 4;
+
+// Little-endian limbs in [0, base), zero is an empty vector.
+using Limbs = SmallVector<Limb, kInlineLimbs>;
+
+// Base of the limbs, anything in [2, 2^32]. Power of two bases split
+// wide values with shifts and masks instead of divisions.
+class Radix {
+ public:
+    explicit constexpr Radix(uint64_t base)
+            : base(base),
+              mask(base - 1),
+              shift(ShiftOf(base)) {}
+
+    uint64_t Base() const {
+        return base;
+    }
+
+    bool IsPowerOfTwo() const {
+        return shift >= 0;
+    }
+
+    // Bits per limb for a power of two base, -1 otherwise.
+    int Bits() const {
+        return shift;
+    }
+
+    // Largest m such that m * base still fits into Wide.
+    uint64_t MaxSmall() const {
+        return std::numeric_limits<Wide>::max() / base;
+    }
+
+    // x % base
+    Limb Low(Wide x) const {
+        return Limb(shift >= 0 ? x & mask : x % base);
+    }
+
+    // x / base
+    Wide High(Wide x) const {
+        return (shift >= 0 ? x >> shift : x / base);
+    }
+
+    Limb Low(DoubleWide x) const {
+        if (shift >= 0 || !(x >> 64)) {
+            return Low(Wide(x));
+        }
+        return Limb(x % base);
+    }
+
+    DoubleWide High(DoubleWide x) const {
+        if (shift >= 0) {
+            return x >> shift;
+        }
+        return (x >> 64 ? x / base : High(Wide(x)));
+    }
+
+ private:
+    // log2(base) for a power of two, -1 otherwise.
+    static constexpr int ShiftOf(uint64_t base) {
+        if (base & (base - 1)) {
+            return -1;
+        }
+        int shift = 0;
+        while ((uint64_t(1) << shift) < base) {
+            shift++;
+        }
+        return shift;
+    }
+
+    uint64_t base;
+    uint64_t mask;
+    int shift;
+};
+
+void Trim(Limbs &a);
+Limbs Slice(const Limbs &a, size_t from, size_t len);
+
+// Returns -1, 0 or 1, both operands must be trimmed.
+int Compare(const Limbs &a, const Limbs &b);
+
+Limbs FromWord(uint64_t value, const Radix &radix);
+
+Limbs Add(const Limbs &a, const Limbs &b, const Radix &radix);
+// Requires a >= b.
+Limbs Sub(const Limbs &a, const Limbs &b, const Radix &radix);
+// a -= b, requires a >= b.
+void SubInPlace(Limbs &a, const Limbs &b, const Radix &radix);
+// a = b - a, requires b >= a.
+void ReverseSub(Limbs &a, const Limbs &b, const Radix &radix);
+// dst += src * base^shift
+void AddShifted(Limbs &dst, const Limbs &src, size_t shift,
+                const Radix &radix);
+
+// Both require 0 < m <= radix.MaxSmall().
+void MulSmall(Limbs &a, uint64_t m, const Radix &radix);
+uint64_t DivideBySmall(Limbs &a, uint64_t d, const Radix &radix);
+
+// Single-word kernels, a must be trimmed. They work in place and only
+// allocate when a outgrows its storage.
+int CompareWord(const Limbs &a, uint64_t value, const Radix &radix);
+// Requires a < 2^64.
+uint64_t ToWord(const Limbs &a, const Radix &radix);
+void AddWord(Limbs &a, uint64_t value, const Radix &radix);
+// Requires a >= value.
+void SubWord(Limbs &a, uint64_t value, const Radix &radix);
+void MulWord(Limbs &a, uint64_t m, const Radix &radix);
+// Both require d > 0 and return the remainder.
+uint64_t DivideByWord(Limbs &a, uint64_t d, const Radix &radix);
+uint64_t ModWord(const Limbs &a, uint64_t d, const Radix &radix);
+
+}  // namespace magnitude
+
+}  // namespace big_num_arithmetic
+
+#endif  // MAGNITUDE_H_
@@ -1,149 +1,293 @@
-#include <iostream>
-#include <stdexcept>
-
-#include "big_integer.h"
-#include "equation_solver.h"
-
-using equation_solver::big_num_arithmetic::GenerateEquation;
-
-enum OperationType {
-    kInt64Cast,
-    kInc,
-    kDec,
-    kPlus,
-    kMinus,
-    kMult,
-    kDiv,
-    kEq, kNe,
-    kLt, kLe,
-    kGt, kGe,
-    kMod,
-    kEquationSolve,
-    kUnknownOperation
-};
-
-OperationType GetOperationType(const std::string &str) {
-    if (str == "int64_t") return kInt64Cast;
-    if (str == "++")      return kInc;
-    if (str == "--")      return kDec;
-    if (str == "+")       return kPlus;
-    if (str == "-")       return kMinus;
-    if (str == "*")       return kMult;
-    if (str == "/")       return kDiv;
-    if (str == "==")      return kEq;
-    if (str == "!=")      return kNe;
-    if (str == "<")       return kLt;
-    if (str == "<=")      return kLe;
-    if (str == ">")       return kGt;
-    if (str == ">=")      return kGe;
-    if (str == "%")       return kMod;
-    if (str == "equation_solve") return kEquationSolve;
-
-    return kUnknownOperation;
-}
-
-int main() {
-    BigInteger::SetInternalBase(4096);
-    std::string operation;
-
-    std::cout << "Input operation : " << std::endl;
-    std::cin >> operation;
-
-    OperationType op = GetOperationType(operation);
-    std::string arg1, arg2, arg3;
-
-    try {
-        if (op == kUnknownOperation) {
-            std::cout << "Unknown operation\n";
-        } else if (op < kPlus) {
-            std::cout << "Input value to modify : ";
-            std::cin >> arg1;
-            BigInteger a = BigInteger::FromString(arg1, 10);
-            std::cout << "Result : ";
-            switch (op) {
-                case kInt64Cast:
-                    std::cout << int64_t(a) << "\n";
-                    break;
-                case kInc:
-                    a++;
-                    std::cout << a.ToString(10) << std::endl;
-                    break;
-                case kDec:
-                    a--;
-                    std::cout << a.ToString(10) << std::endl;
-                    break;
-            }
-        } else if (kPlus <= op && op <= kMod) {
-            std::cout << "Input left value : ";
-            std::cin >> arg1;
-            std::cout << "Input right value : ";
-            std::cin >> arg2;
-
-            BigInteger l = BigInteger::FromString(arg1, 10);
-            BigInteger r = BigInteger::FromString(arg2, 10);
-            std::cout << "Result : ";
-            switch (op) {
-                case kPlus :
-                    std::cout << (l += r).ToString(10) << "\n";
-                    break;
-                case kMinus :
-                    std::cout << (l -= r).ToString(10) << "\n";
-                    break;
-                case kMult :
-                    std::cout << (l *= r).ToString(10) << "\n";
-                    break;
-                case kDiv :
-                    std::cout << (l /= r).ToString(10) << "\n";
-                    break;
-                case kEq :
-                    std::cout << std::boolalpha << (l == r) << "\n";
-                    break;
-                case kNe :
-                    std::cout << std::boolalpha << (l != r) << "\n";
-                    break;
-                case kLe :
-                    std::cout << std::boolalpha << (l <= r) << "\n";
-                    break;
-                case kLt :
-                    std::cout << std::boolalpha << (l < r) << "\n";
-                    break;
-                case kGe :
-                    std::cout << std::boolalpha << (l >= r) << "\n";
-                    break;
-                case kGt :
-                    std::cout << std::boolalpha << (l > r) << "\n";
-                    break;
-                case kMod:
-                    uint32_t mod = l % uint32_t(int64_t(r));
-                    std::cout << mod << "\n";
-                    break;
-            }
-        } else {
-            std::cout << "Input a koef : ";
-            std::cin >> arg1;
-            std::cout << "Input x1 root : ";
-            std::cin >> arg2;
-            std::cout << "Input x2 root : ";
-            std::cin >> arg3;
-
-            BigInteger a = BigInteger::FromString(arg1, 10);
-            BigInteger x1 = BigInteger::FromString(arg2, 10);
-            BigInteger x2 = BigInteger::FromString(arg3, 10);
-
-            equation_solver::QuadraticEquation eq =
-                    GenerateEquation(a, x1, x2);
-
-            std::cout << std::boolalpha
-                      << equation_solver::Solve(eq, x1, x2) << "\n";
-        }
-    } catch (big_num_arithmetic::DivisionByZeroError) {
-        std::cout << "Division by zero error" << std::endl;
-    } catch (std::logic_error &e) {
-        std::cout << e.what() << std::endl;
-    } catch (std::runtime_error &e) {
-        std::cout << e.what() << std::endl;
-    } catch (...) {
-        std::cout << "Undefined behaviour\n";
-    }
-    return 0;
-}
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "big_integer.h"
+#include "equation_solver.h"
+#include "mapped_file.h"
+#include "thread_pool.h"
+
+using equation_solver::big_num_arithmetic::GenerateEquation;
+
+enum OperationType {
+    kInt64Cast,
+    kInc,
+    kDec,
+    kPlus,
+    kMinus,
+    kMult,
+    kDiv,
+    kEq, kNe,
+    kLt, kLe,
+    kGt, kGe,
+    kMod,
+    kEquationSolve,
+    kUnknownOperation
+};
+
+OperationType GetOperationType(const std::string &str) {
+    if (str == "int64_t") return kInt64Cast;
+    if (str == "++")      return kInc;
+    if (str == "--")      return kDec;
+    if (str == "+")       return kPlus;
+    if (str == "-")       return kMinus;
+    if (str == "*")       return kMult;
+    if (str == "/")       return kDiv;
+    if (str == "==")      return kEq;
+    if (str == "!=")      return kNe;
+    if (str == "<")       return kLt;
+    if (str == "<=")      return kLe;
+    if (str == ">")       return kGt;
+    if (str == ">=")      return kGe;
+    if (str == "%")       return kMod;
+    if (str == "equation_solve") return kEquationSolve;
+
+    return kUnknownOperation;
+}
+
+int GetArgumentCount(OperationType op) {
+    if (op < kPlus) return 1;
+    if (op <= kMod) return 2;
+    return 3;
+}
+
+std::string ToString(bool value) {
+    return value ? "true" : "false";
+}
+
+// Result of op on the decimal arguments args[0..GetArgumentCount(op)).
+std::string Evaluate(OperationType op, const std::string *args) {
+    if (op < kPlus) {
+        BigInteger a = BigInteger::FromString(args[0], 10);
+        switch (op) {
+            case kInt64Cast:
+                return std::to_string(int64_t(a));
+            case kInc:
+                return (++a).ToString(10);
+            default:
+                return (--a).ToString(10);
+        }
+    } else if (op <= kMod) {
+        BigInteger l = BigInteger::FromString(args[0], 10);
+        BigInteger r = BigInteger::FromString(args[1], 10);
+        switch (op) {
+            case kPlus :
+                return (l += r).ToString(10);
+            case kMinus :
+                return (l -= r).ToString(10);
+            case kMult :
+                return (l *= r).ToString(10);
+            case kDiv :
+                return (l /= r).ToString(10);
+            case kEq :
+                return ToString(l == r);
+            case kNe :
+                return ToString(l != r);
+            case kLe :
+                return ToString(l <= r);
+            case kLt :
+                return ToString(l < r);
+            case kGe :
+                return ToString(l >= r);
+            case kGt :
+                return ToString(l > r);
+            default:
+                return std::to_string(l % uint32_t(int64_t(r)));
+        }
+    }
+
+    BigInteger a = BigInteger::FromString(args[0], 10);
+    BigInteger x1 = BigInteger::FromString(args[1], 10);
+    BigInteger x2 = BigInteger::FromString(args[2], 10);
+
+    equation_solver::QuadraticEquation eq = GenerateEquation(a, x1, x2);
+    return ToString(equation_solver::Solve(eq, x1, x2));
+}
+
+// Evaluate, with errors turned into their messages.
+std::string EvaluateOrError(OperationType op, const std::string *args) {
+    try {
+        return Evaluate(op, args);
+    } catch (const big_num_arithmetic::DivisionByZeroError &) {
+        return "Division by zero error";
+    } catch (std::logic_error &e) {
+        return e.what();
+    } catch (std::runtime_error &e) {
+        return e.what();
+    } catch (...) {
+        return "Undefined behaviour";
+    }
+}
+
+int RunInteractive() {
+    std::string operation;
+
+    std::cout << "Input operation : " << std::endl;
+    std::cin >> operation;
+
+    OperationType op = GetOperationType(operation);
+    std::string args[3];
+
+    if (op == kUnknownOperation) {
+        std::cout << "Unknown operation\n";
+        return 0;
+    }
+
+    if (op < kPlus) {
+        std::cout << "Input value to modify : ";
+        std::cin >> args[0];
+    } else if (op <= kMod) {
+        std::cout << "Input left value : ";
+        std::cin >> args[0];
+        std::cout << "Input right value : ";
+        std::cin >> args[1];
+    } else {
+        std::cout << "Input a koef : ";
+        std::cin >> args[0];
+        std::cout << "Input x1 root : ";
+        std::cin >> args[1];
+        std::cout << "Input x2 root : ";
+        std::cin >> args[2];
+    }
+
+    if (op < kEquationSolve) {
+        std::cout << "Result : ";
+    }
+    std::cout << EvaluateOrError(op, args) << std::endl;
+    return 0;
+}
+
+// Input is cut into chunks of about this many bytes at line ends.
+constexpr size_t kChunkBytes = size_t(1) << 20;
+
+// Evaluates every "op arg..." line of [first, last) and appends one
+// result line per non-empty input line to out.
+size_t EvaluateChunk(const char *first, const char *last, std::string &out) {
+    size_t lines = 0;
+    std::string tokens[4];
+    while (first < last) {
+        const char *end = static_cast<const char *>(
+                std::memchr(first, '\n', last - first));
+        if (!end) {
+            end = last;
+        }
+
+        int count = 0;
+        for (const char *p = first; p < end;) {
+            while (p < end && std::isspace(static_cast<unsigned char>(*p))) {
+                p++;
+            }
+            const char *start = p;
+            while (p < end && !std::isspace(static_cast<unsigned char>(*p))) {
+                p++;
+            }
+            if (start < p) {
+                if (count < 4) {
+                    tokens[count].assign(start, p);
+                }
+                count++;
+            }
+        }
+        first = end + 1;
+        if (count == 0) {
+            continue;
+        }
+
+        lines++;
+        OperationType op = GetOperationType(tokens[0]);
+        if (op == kUnknownOperation) {
+            out += "Unknown operation";
+        } else if (count != GetArgumentCount(op) + 1) {
+            out += "Wrong number of arguments";
+        } else {
+            out += EvaluateOrError(op, tokens + 1);
+        }
+        out += '\n';
+    }
+    return lines;
+}
+
+// Evaluates an input file line by line, usage:
+// big_integer --batch input [output].
+int RunBatch(const char *input, const char *output) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+
+    big_num_arithmetic::MappedFile file(input);
+    FILE *out = (output ? std::fopen(output, "wb") : stdout);
+    if (!out) {
+        throw std::runtime_error(std::string("Cannot open ") + output);
+    }
+    std::setvbuf(out, nullptr, _IOFBF, kChunkBytes);
+
+    std::vector<const char *> bounds{file.Data()};
+    const char *last = file.Data() + file.Size();
+    while (bounds.back() != last) {
+        const char *end = bounds.back() + std::min<size_t>(
+                kChunkBytes, last - bounds.back());
+        if (end != last) {
+            const char *newline = static_cast<const char *>(
+                    std::memchr(end, '\n', last - end));
+            end = (newline ? newline + 1 : last);
+        }
+        bounds.push_back(end);
+    }
+    size_t chunks = bounds.size() - 1;
+
+    // A window of chunks is evaluated in parallel and then written in
+    // order, which bounds the memory held by pending results.
+    big_num_arithmetic::ThreadPool pool;
+    size_t window = 4 * pool.Size();
+    std::vector<std::string> results(window);
+    std::vector<size_t> lines(window);
+    size_t total_lines = 0;
+    for (size_t begin = 0; begin < chunks; begin += window) {
+        size_t count = std::min(window, chunks - begin);
+        pool.ParallelFor(count, 1, [&](size_t from, size_t to, size_t) {
+            for (size_t i = from; i < to; i++) {
+                results[i].clear();
+                lines[i] = EvaluateChunk(bounds[begin + i],
+                                         bounds[begin + i + 1], results[i]);
+            }
+        });
+        for (size_t i = 0; i < count; i++) {
+            std::fwrite(results[i].data(), 1, results[i].size(), out);
+            total_lines += lines[i];
+        }
+    }
+    std::fflush(out);
+    if (output) {
+        std::fclose(out);
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start)
+            .count();
+    std::cerr << total_lines << " lines, " << file.Size() << " bytes in "
+              << seconds << " s: " << total_lines / seconds << " lines/s, "
+              << file.Size() / seconds / (1 << 20) << " MiB/s using "
+              << pool.Size() << " threads" << std::endl;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        if (argc < 3) {
+            std::cerr << "Usage: " << argv[0] << " --batch input [output]"
+                      << std::endl;
+            return 1;
+        }
+        try {
+            return RunBatch(argv[2], argc > 3 ? argv[3] : nullptr);
+        } catch (std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+    return RunInteractive();
+}
@@ -0,0 +1,93 @@
+#include <stdexcept>
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace big_num_arithmetic {
+
+    MappedFile::MappedFile(const char *path) {
+#ifdef _WIN32
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error(std::string("Cannot open ") + path);
+        }
+        contents.assign(std::istreambuf_iterator<char>(in),
+                        std::istreambuf_iterator<char>());
+#else
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error(std::string("Cannot open ") + path);
+        }
+        struct stat st;
+        if (fstat(fd, &st) < 0) {
+            close(fd);
+            throw std::runtime_error(std::string("Cannot stat ") + path);
+        }
+
+        // Only regular files report their length, so a pipe would look
+        // empty and is read to its end instead.
+        if (S_ISREG(st.st_mode)) {
+            size = st.st_size;
+            if (size) {
+                void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd,
+                                 0);
+                if (map == MAP_FAILED) {
+                    close(fd);
+                    throw std::runtime_error(std::string("Cannot map ") +
+                                             path);
+                }
+                data = static_cast<const char *>(map);
+                mapped = true;
+                madvise(map, size, MADV_SEQUENTIAL);
+            }
+            close(fd);
+            return;
+        }
+
+        char buffer[1 << 16];
+        while (true) {
+            ssize_t got = read(fd, buffer, sizeof(buffer));
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got < 0) {
+                close(fd);
+                throw std::runtime_error(std::string("Cannot read ") + path);
+            }
+            if (got == 0) {
+                break;
+            }
+            contents.append(buffer, got);
+        }
+        close(fd);
+#endif
+        data = contents.data();
+        size = contents.size();
+    }
+
+    MappedFile::~MappedFile() {
+#ifndef _WIN32
+        if (mapped) {
+            munmap(const_cast<char *>(data), size);
+        }
+#endif
+    }
+
+    const char *MappedFile::Data() const {
+        return data;
+    }
+
+    size_t MappedFile::Size() const {
+        return size;
+    }
+
+}  // namespace big_num_arithmetic
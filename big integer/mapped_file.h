@@ -0,0 +1,34 @@
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace big_num_arithmetic {
+
+// Read-only mapping of a whole file. Pipes and other files that cannot
+// be mapped, and every file where mmap is not available, are read into
+// memory instead. Mappings start on a page boundary, so the words of
+// serialized values in them are aligned.
+class MappedFile {
+ public:
+    // Throws std::runtime_error if the file cannot be opened or read.
+    explicit MappedFile(const char *path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *Data() const;
+    size_t Size() const;
+
+ private:
+    const char *data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    std::string contents;
+};
+
+}  // namespace big_num_arithmetic
+
+#endif  // MAPPED_FILE_H_
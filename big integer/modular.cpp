@@ -0,0 +1,242 @@
+#include <stdexcept>
+#include <utility>
+#include "bitwise.h"
+#include "division.h"
+#include "modular.h"
+#include "radix_conversion.h"
+
+namespace big_num_arithmetic {
+
+namespace modular {
+
+using magnitude::Limb;
+using magnitude::Wide;
+using magnitude::DoubleWide;
+
+namespace {
+
+    const Radix kBinary(uint64_t(1) << 32);
+
+    // Bits of words starting at bit shift, at most 64 of them.
+    uint64_t BitsAt(const Limbs &words, size_t shift) {
+        size_t index = shift / 32;
+        DoubleWide value = 0;
+        for (size_t i = 0; i < 3 && index + i < words.size(); i++) {
+            value |= DoubleWide(words[index + i]) << (32 * i);
+        }
+        return uint64_t(value >> (shift % 32));
+    }
+
+    uint64_t BinaryGcd(uint64_t a, uint64_t b) {
+        if (a == 0 || b == 0) {
+            return a | b;
+        }
+        int shift = __builtin_ctzll(a | b);
+        a >>= __builtin_ctzll(a);
+        while (b) {
+            b >>= __builtin_ctzll(b);
+            if (a > b) {
+                std::swap(a, b);
+            }
+            b -= a;
+        }
+        return a << shift;
+    }
+
+    // -a^(-1) mod base with the extended Euclidean algorithm.
+    Limb NegatedInverse(Limb a, const Radix &radix) {
+        int64_t base = radix.Base();
+        int64_t r0 = base, r1 = a;
+        int64_t t0 = 0, t1 = 1;
+        while (r1) {
+            int64_t q = r0 / r1;
+            std::swap(r0, r1);
+            r1 -= q * r0;
+            std::swap(t0, t1);
+            t1 -= q * t0;
+        }
+        if (r0 != 1) {
+            throw std::logic_error("Modulus must be coprime to the base");
+        }
+        t0 %= base;
+        return Limb(t0 <= 0 ? -t0 : base - t0);
+    }
+
+}  // namespace
+
+    Bits ToBits(const Limbs &exponent, const Radix &radix) {
+        if (!radix.IsPowerOfTwo()) {
+            return radix_conversion::ToDigits(exponent, 2, radix);
+        }
+
+        Bits bits;
+        for (size_t i = exponent.size(); i-- > 0;) {
+            for (uint64_t bit = radix.Base() >> 1; bit; bit >>= 1) {
+                if (!bits.empty() || (exponent[i] & bit)) {
+                    bits.push_back((exponent[i] & bit) != 0);
+                }
+            }
+        }
+        return bits;
+    }
+
+    Montgomery::Montgomery(const Limbs &modulus, const Radix &radix)
+            : modulus(modulus),
+              radix(radix) {
+        magnitude::Trim(this->modulus);
+        if (this->modulus.empty()) {
+            throw std::logic_error("Zero modulus");
+        }
+        inverse = NegatedInverse(this->modulus[0], radix);
+
+        size_t n = this->modulus.size();
+        Limbs power(2 * n + 1, 0);
+        Limbs quotient;
+        power.back() = 1;
+        division::DivMod(power, this->modulus, radix, quotient, r2);
+        power.resize(n + 1);
+        power.back() = 1;
+        division::DivMod(power, this->modulus, radix, quotient, one);
+    }
+
+    Limbs Montgomery::ToMontgomery(const Limbs &a) const {
+        return Multiply(a, r2);
+    }
+
+    Limbs Montgomery::FromMontgomery(const Limbs &a) const {
+        return Multiply(a, Limbs{1});
+    }
+
+    Limbs Montgomery::Multiply(const Limbs &a, const Limbs &b) const {
+        // Coarsely integrated operand scanning: every step adds a[i] * b
+        // and a multiple of the modulus that clears the lowest limb,
+        // then drops that limb.
+        size_t n = modulus.size();
+        Limbs t(n + 2, 0);
+        for (size_t i = 0; i < n; i++) {
+            Wide x = (i < a.size() ? a[i] : 0);
+            Wide carry = 0;
+            for (size_t j = 0; j < n; j++) {
+                Wide cur = Wide(t[j]) + x * (j < b.size() ? b[j] : 0) + carry;
+                t[j] = radix.Low(cur);
+                carry = radix.High(cur);
+            }
+            Wide cur = Wide(t[n]) + carry;
+            t[n] = radix.Low(cur);
+            t[n + 1] = Limb(radix.High(cur));
+
+            Wide u = radix.Low(Wide(t[0]) * inverse);
+            carry = radix.High(Wide(t[0]) + u * modulus[0]);
+            for (size_t j = 1; j < n; j++) {
+                cur = Wide(t[j]) + u * modulus[j] + carry;
+                t[j - 1] = radix.Low(cur);
+                carry = radix.High(cur);
+            }
+            cur = Wide(t[n]) + carry;
+            t[n - 1] = radix.Low(cur);
+            t[n] = Limb(t[n + 1] + radix.High(cur));
+            t[n + 1] = 0;
+        }
+
+        magnitude::Trim(t);
+        if (magnitude::Compare(t, modulus) >= 0) {
+            magnitude::SubInPlace(t, modulus, radix);
+        }
+        return t;
+    }
+
+    Limbs Montgomery::Pow(const Limbs &base, const Bits &exponent) const {
+        return SlidingWindowPow(base, exponent, one,
+                                [this](const Limbs &x, const Limbs &y) {
+                                    return Multiply(x, y);
+                                });
+    }
+
+    const Limbs &Montgomery::One() const {
+        return one;
+    }
+
+    const Limbs &Montgomery::Modulus() const {
+        return modulus;
+    }
+
+    bool LehmerStep(const Limbs &a, const Limbs &b, LehmerMatrix &m) {
+        size_t bits = bitwise::BitLength(a);
+        size_t shift = (bits > 62 ? bits - 62 : 0);
+        int64_t x = BitsAt(a, shift);
+        int64_t y = BitsAt(b, shift);
+
+        // Knuth's algorithm L: a step is taken only when both ends of
+        // the interval the leading bits leave give the same quotient.
+        m = {1, 0, 0, 1};
+        while (y + m.c > 0 && y + m.d > 0) {
+            int64_t q = (x + m.a) / (y + m.c);
+            if (q != (x + m.b) / (y + m.d)) {
+                break;
+            }
+            m = {m.c, m.d, m.a - q * m.c, m.b - q * m.d};
+            x -= q * y;
+            std::swap(x, y);
+        }
+        return m.b != 0;
+    }
+
+    void ApplyLehmer(Limbs &a, Limbs &b, const LehmerMatrix &m) {
+        using SignedWide = __int128;
+
+        b.resize(a.size(), 0);
+        SignedWide carry_a = 0, carry_b = 0;
+        for (size_t i = 0; i < a.size(); i++) {
+            SignedWide x = a[i], y = b[i];
+            carry_a += m.a * x + m.b * y;
+            carry_b += m.c * x + m.d * y;
+            a[i] = Limb(carry_a);
+            b[i] = Limb(carry_b);
+            carry_a >>= 32;
+            carry_b >>= 32;
+        }
+        magnitude::Trim(a);
+        magnitude::Trim(b);
+    }
+
+    void EuclidStep(Limbs &a, Limbs &b, Limbs &quotient) {
+        Limbs remainder;
+        division::DivMod(a, b, kBinary, quotient, remainder);
+        magnitude::Trim(quotient);
+        magnitude::Trim(remainder);
+        a = std::move(b);
+        b = std::move(remainder);
+    }
+
+    Limbs Gcd(Limbs a, Limbs b) {
+        magnitude::Trim(a);
+        magnitude::Trim(b);
+        if (magnitude::Compare(a, b) < 0) {
+            std::swap(a, b);
+        }
+
+        // Lehmer's steps win from three words on, the binary algorithm
+        // takes over once both numbers fit in a word.
+        Limbs quotient;
+        while (b.size() > 2) {
+            LehmerMatrix m;
+            if (LehmerStep(a, b, m)) {
+                ApplyLehmer(a, b, m);
+            } else {
+                EuclidStep(a, b, quotient);
+            }
+        }
+        if (b.empty()) {
+            return a;
+        }
+        if (a.size() > 2) {
+            EuclidStep(a, b, quotient);
+        }
+        return magnitude::FromWord(BinaryGcd(magnitude::ToWord(a, kBinary),
+                                             magnitude::ToWord(b, kBinary)),
+                                   kBinary);
+    }
+
+}  // namespace modular
+
+}  // namespace big_num_arithmetic
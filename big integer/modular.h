@@ -0,0 +1,125 @@
+#ifndef MODULAR_H_
+#define MODULAR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "magnitude.h"
+
+namespace big_num_arithmetic {
+
+namespace modular {
+
+using Limbs = magnitude::Limbs;
+using magnitude::Radix;
+
+// Exponent bits, the most significant first.
+using Bits = std::vector<uint8_t>;
+
+Bits ToBits(const Limbs &exponent, const Radix &radix);
+
+// Left-to-right sliding window exponentiation, multiply(x, y) must
+// return the reduced product. one is the identity of multiply.
+template<typename Multiply>
+Limbs SlidingWindowPow(const Limbs &base, const Bits &bits,
+                       const Limbs &one, Multiply multiply) {
+    size_t window = 1;
+    for (size_t limit : {24, 80, 240, 672}) {
+        window += (bits.size() > limit);
+    }
+
+    // base^1, base^3, ..., base^(2^window - 1)
+    std::vector<Limbs> odd{base};
+    if (window > 1) {
+        Limbs square = multiply(base, base);
+        for (size_t i = 1; i < (size_t(1) << (window - 1)); i++) {
+            odd.push_back(multiply(odd.back(), square));
+        }
+    }
+
+    Limbs res = one;
+    bool started = false;
+    for (size_t i = 0; i < bits.size();) {
+        if (!bits[i]) {
+            if (started) {
+                res = multiply(res, res);
+            }
+            i++;
+            continue;
+        }
+
+        // The longest window starting at i that ends with a one bit.
+        size_t last = std::min(i + window, bits.size()) - 1;
+        while (!bits[last]) {
+            last--;
+        }
+        size_t value = 0;
+        for (size_t j = i; j <= last; j++) {
+            value = 2 * value + bits[j];
+            if (started) {
+                res = multiply(res, res);
+            }
+        }
+        res = (started ? multiply(res, odd[value / 2]) : odd[value / 2]);
+        started = true;
+        i = last + 1;
+    }
+    return res;
+}
+
+// Montgomery multiplication modulo a fixed modulus coprime to the base,
+// with R = base^n for a modulus of n limbs.
+class Montgomery {
+ public:
+    Montgomery(const Limbs &modulus, const Radix &radix);
+
+    // Requires a < modulus.
+    Limbs ToMontgomery(const Limbs &a) const;
+    Limbs FromMontgomery(const Limbs &a) const;
+
+    // a * b / R mod modulus, both in Montgomery form.
+    Limbs Multiply(const Limbs &a, const Limbs &b) const;
+
+    // base^exponent with base and result in Montgomery form.
+    Limbs Pow(const Limbs &base, const Bits &exponent) const;
+
+    // R mod modulus, 1 in Montgomery form.
+    const Limbs &One() const;
+    const Limbs &Modulus() const;
+
+ private:
+    Limbs modulus;
+    Radix radix;
+    // -modulus^(-1) mod base
+    magnitude::Limb inverse;
+    Limbs one;
+    // R^2 mod modulus
+    Limbs r2;
+};
+
+// The GCD functions take binary words, see bitwise::ToBinary, and keep
+// a >= b on both sides.
+
+// Lehmer's step: the Euclid steps on a and b that their leading 62 bits
+// alone decide, as the matrix taking (a, b) to the new pair.
+struct LehmerMatrix {
+    int64_t a, b, c, d;
+};
+
+// False when the leading bits decide no step, which takes a full
+// division then.
+bool LehmerStep(const Limbs &a, const Limbs &b, LehmerMatrix &m);
+// (a, b) = (m.a * a + m.b * b, m.c * a + m.d * b) in place.
+void ApplyLehmer(Limbs &a, Limbs &b, const LehmerMatrix &m);
+// (a, b) = (b, a mod b), requires b > 0.
+void EuclidStep(Limbs &a, Limbs &b, Limbs &quotient);
+
+// Lehmer's algorithm down to two words, then the binary one.
+Limbs Gcd(Limbs a, Limbs b);
+
+}  // namespace modular
+
+}  // namespace big_num_arithmetic
+
+#endif  // MODULAR_H_
@@ -0,0 +1,709 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "multiplication.h"
+#include "thread_pool.h"
+
+namespace big_num_arithmetic {
+
+namespace multiplication {
+
+using magnitude::DoubleWide;
+using magnitude::Limb;
+using magnitude::Wide;
+using magnitude::Trim;
+using magnitude::Slice;
+using magnitude::Compare;
+using magnitude::Add;
+using magnitude::Sub;
+using magnitude::AddShifted;
+using magnitude::MulSmall;
+using magnitude::DivideBySmall;
+
+namespace {
+
+    // Per thread, so tuning it never races with other threads' products.
+    thread_local size_t ntt_threshold = kDefaultNttThreshold;
+
+    // The fewest NTT elements worth a chunk of their own.
+    constexpr size_t kNttGrain = 1 << 14;
+
+    // a = base^n - a for n = a.size(), returns whether a was non-zero.
+    bool Complement(Limbs &a, const Radix &radix) {
+        size_t k = 0;
+        while (k < a.size() && a[k] == 0) {
+            k++;
+        }
+        if (k == a.size()) {
+            return false;
+        }
+        a[k] = Limb(radix.Base() - a[k]);
+        for (k++; k < a.size(); k++) {
+            a[k] = Limb(radix.Base() - 1 - a[k]);
+        }
+        return true;
+    }
+
+    // The pool of this thread for products of this size, if any.
+    ThreadPool *PoolFor(size_t shorter) {
+        ThreadPool *pool = CurrentThreadPool();
+        if (shorter < kParallelThreshold || !pool || pool->Size() == 1) {
+            return nullptr;
+        }
+        return pool;
+    }
+
+    // body(begin, end) over [0, count), in a few chunks per thread of
+    // at least grain indices when there is a pool.
+    template<typename Body>
+    void ForRange(ThreadPool *pool, size_t count, size_t grain,
+                  const Body &body) {
+        if (!pool) {
+            body(0, count);
+            return;
+        }
+        grain = std::max(grain, (count + 4 * pool->Size() - 1) /
+                                (4 * pool->Size()));
+        pool->ParallelFor(count, grain,
+                          [&body](size_t begin, size_t end, size_t) {
+            body(begin, end);
+        });
+    }
+
+    // The lowest bits bits of i in reverse order.
+    size_t ReverseBits(uint64_t i, int bits) {
+        i = ((i >> 1) & 0x5555555555555555) | ((i & 0x5555555555555555) << 1);
+        i = ((i >> 2) & 0x3333333333333333) | ((i & 0x3333333333333333) << 2);
+        i = ((i >> 4) & 0x0F0F0F0F0F0F0F0F) | ((i & 0x0F0F0F0F0F0F0F0F) << 4);
+        i = __builtin_bswap64(i);
+        return (bits ? i >> (64 - bits) : 0);
+    }
+
+    struct SignedLimbs {
+        Limbs magnitude;
+        bool negative = false;
+    };
+
+    SignedLimbs AddSigned(const SignedLimbs &a, const SignedLimbs &b,
+                          const Radix &radix) {
+        SignedLimbs res;
+        if (a.negative == b.negative) {
+            res.magnitude = Add(a.magnitude, b.magnitude, radix);
+            res.negative = a.negative;
+        } else if (Compare(a.magnitude, b.magnitude) >= 0) {
+            res.magnitude = Sub(a.magnitude, b.magnitude, radix);
+            res.negative = a.negative;
+        } else {
+            res.magnitude = Sub(b.magnitude, a.magnitude, radix);
+            res.negative = b.negative;
+        }
+        res.negative = res.negative && !res.magnitude.empty();
+        return res;
+    }
+
+    SignedLimbs SubSigned(const SignedLimbs &a, SignedLimbs b,
+                          const Radix &radix) {
+        b.negative = !b.negative;
+        return AddSigned(a, b, radix);
+    }
+
+    SignedLimbs MultiplySigned(const SignedLimbs &a, const SignedLimbs &b,
+                               const Radix &radix) {
+        SignedLimbs res;
+        res.magnitude = Multiply(a.magnitude, b.magnitude, radix);
+        res.negative = (a.negative != b.negative) && !res.magnitude.empty();
+        return res;
+    }
+
+    // Values of a2 x^2 + a1 x + a0 at 0, 1, -1, -2 and infinity.
+    std::vector<SignedLimbs> ToomCook3Evaluate(const Limbs &a0,
+                                               const Limbs &a1,
+                                               const Limbs &a2,
+                                               const Radix &radix) {
+        Limbs s = Add(a0, a2, radix);
+        SignedLimbs v1 = {Add(s, a1, radix), false};
+        SignedLimbs vm1 = SubSigned({s, false}, {a1, false}, radix);
+        SignedLimbs vm2 = AddSigned(vm1, {a2, false}, radix);
+        MulSmall(vm2.magnitude, 2, radix);
+        vm2 = SubSigned(vm2, {a0, false}, radix);
+
+        return {{a0, false}, v1, vm1, vm2, {a2, false}};
+    }
+
+    constexpr uint64_t PowMod(uint64_t a, uint64_t e, uint64_t mod) {
+        uint64_t res = 1;
+        a %= mod;
+        while (e) {
+            if (e & 1) {
+                res = res * a % mod;
+            }
+            a = a * a % mod;
+            e >>= 1;
+        }
+        return res;
+    }
+
+    // Mod must be a prime below 2^31 and Root its primitive root.
+    template <uint32_t Mod, uint32_t Root>
+    struct NttPrime {
+        static constexpr uint64_t kMod = Mod;
+
+        static void Transform(std::vector<uint32_t> &a, bool invert,
+                              ThreadPool *pool) {
+            size_t n = a.size();
+            int bits = __builtin_ctzll(n);
+            // Each pair is swapped once, from its smaller index.
+            ForRange(pool, n, kNttGrain, [&a, bits](size_t begin,
+                                                    size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    size_t j = ReverseBits(i, bits);
+                    if (i < j) {
+                        std::swap(a[i], a[j]);
+                    }
+                }
+            });
+
+            std::vector<uint32_t> w(n / 2 + 1);
+            for (size_t len = 2; len <= n; len <<= 1) {
+                uint64_t w_len = PowMod(Root, (Mod - 1) / len, Mod);
+                if (invert) {
+                    w_len = PowMod(w_len, Mod - 2, Mod);
+                }
+                size_t half = len / 2;
+                ForRange(pool, half, kNttGrain, [&w, w_len](size_t begin,
+                                                            size_t end) {
+                    uint64_t x = PowMod(w_len, begin, Mod);
+                    for (size_t k = begin; k < end; k++) {
+                        w[k] = x;
+                        x = x * w_len % Mod;
+                    }
+                });
+
+                // Butterfly t is number t % half of block t / half.
+                ForRange(pool, n / 2, kNttGrain, [&](size_t begin,
+                                                     size_t end) {
+                    for (size_t t = begin; t < end;) {
+                        size_t k = t % half;
+                        size_t stop = std::min(half, k + (end - t));
+                        uint32_t *lo = a.data() + t / half * len;
+                        uint32_t *hi = lo + half;
+                        for (size_t m = k; m < stop; m++) {
+                            uint32_t u = lo[m];
+                            uint32_t v = uint64_t(hi[m]) * w[m] % Mod;
+                            lo[m] = (u + v >= Mod ? u + v - Mod : u + v);
+                            hi[m] = (u >= v ? u - v : u + Mod - v);
+                        }
+                        t += stop - k;
+                    }
+                });
+            }
+
+            if (invert) {
+                uint64_t n_inv = PowMod(n, Mod - 2, Mod);
+                ForRange(pool, n, kNttGrain, [&a, n_inv](size_t begin,
+                                                         size_t end) {
+                    for (size_t i = begin; i < end; i++) {
+                        a[i] = a[i] * n_inv % Mod;
+                    }
+                });
+            }
+        }
+
+        static std::vector<uint32_t> Residues(const Limbs &x, size_t len,
+                                              ThreadPool *pool) {
+            std::vector<uint32_t> res(len, 0);
+            ForRange(pool, x.size(), kNttGrain, [&](size_t begin,
+                                                    size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    res[i] = x[i] % Mod;
+                }
+            });
+            return res;
+        }
+
+        static std::vector<uint32_t> Convolve(const Limbs &lhs,
+                                              const Limbs &rhs,
+                                              size_t len,
+                                              ThreadPool *pool) {
+            std::vector<uint32_t> fl = Residues(lhs, len, pool);
+            Transform(fl, false, pool);
+
+            if (&lhs == &rhs) {
+                ForRange(pool, len, kNttGrain, [&fl](size_t begin,
+                                                     size_t end) {
+                    for (size_t i = begin; i < end; i++) {
+                        fl[i] = uint64_t(fl[i]) * fl[i] % Mod;
+                    }
+                });
+            } else {
+                std::vector<uint32_t> fr = Residues(rhs, len, pool);
+                Transform(fr, false, pool);
+                ForRange(pool, len, kNttGrain, [&](size_t begin,
+                                                   size_t end) {
+                    for (size_t i = begin; i < end; i++) {
+                        fl[i] = uint64_t(fl[i]) * fr[i] % Mod;
+                    }
+                });
+            }
+
+            Transform(fl, true, pool);
+            return fl;
+        }
+    };
+
+    using NttPrime1 = NttPrime<2'013'265'921, 31>;
+    using NttPrime2 = NttPrime<1'811'939'329, 13>;
+    using NttPrime3 = NttPrime<2'113'929'217, 5>;
+
+    // Garner's constants for the CRT recombination.
+    constexpr uint64_t kM1 = NttPrime1::kMod;
+    constexpr uint64_t kM2 = NttPrime2::kMod;
+    constexpr uint64_t kM3 = NttPrime3::kMod;
+    constexpr uint64_t kM1InvModM2 = PowMod(kM1, kM2 - 2, kM2);
+    constexpr uint64_t kM12InvModM3 = PowMod(kM1 * kM2 % kM3, kM3 - 2, kM3);
+
+    // Splits the longer operand into chunks as long as the shorter one.
+    // Products of even and of odd chunks do not overlap, so in parallel
+    // they go to two sums that are added at the end.
+    Limbs MultiplyUnbalanced(const Limbs &lng, const Limbs &sht,
+                             const Radix &radix) {
+        size_t step = sht.size();
+        ThreadPool *pool = PoolFor(sht.size());
+        if (!pool) {
+            Limbs res;
+            for (size_t from = 0; from < lng.size(); from += step) {
+                AddShifted(res, Multiply(Slice(lng, from, step), sht, radix),
+                           from, radix);
+            }
+            Trim(res);
+            return res;
+        }
+
+        Limbs sums[2] = {Limbs(lng.size() + step, 0),
+                         Limbs(lng.size() + step, 0)};
+        size_t chunks = (lng.size() + step - 1) / step;
+        ForRange(pool, chunks, 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                Limbs product = Multiply(Slice(lng, i * step, step), sht,
+                                         radix);
+                std::copy(product.begin(), product.end(),
+                          sums[i % 2].begin() + i * step);
+            }
+        });
+        Trim(sums[1]);
+        AddShifted(sums[0], sums[1], 0, radix);
+        Trim(sums[0]);
+        return std::move(sums[0]);
+    }
+
+}  // namespace
+
+    void SetNttThreshold(size_t limbs) {
+        ntt_threshold = limbs;
+    }
+
+    size_t GetNttThreshold() {
+        return ntt_threshold;
+    }
+
+    Limbs Multiply(const Limbs &lhs, const Limbs &rhs, const Radix &radix) {
+        const Limbs &lng = (lhs.size() >= rhs.size() ? lhs : rhs);
+        const Limbs &sht = (lhs.size() >= rhs.size() ? rhs : lhs);
+
+        if (sht.size() < kKaratsubaThreshold) {
+            return MultiplySchoolbook(lng, sht, radix);
+        }
+        if (sht.size() >= ntt_threshold &&
+            lng.size() + sht.size() <= kMaxNttLength) {
+            return MultiplyNtt(lng, sht, radix);
+        }
+        if (sht.size() * 2 <= lng.size()) {
+            return MultiplyUnbalanced(lng, sht, radix);
+        }
+        if (sht.size() < kToomCook3Threshold) {
+            return MultiplyKaratsuba(lng, sht, radix);
+        }
+        return MultiplyToomCook3(lng, sht, radix);
+    }
+
+    void MultiplyInPlace(Limbs &lhs, const Limbs &rhs, const Radix &radix) {
+        if (&lhs == &rhs || lhs.empty() || rhs.empty() ||
+            std::min(lhs.size(), rhs.size()) >= kKaratsubaThreshold) {
+            lhs = Multiply(lhs, rhs, radix);
+            return;
+        }
+
+        size_t lsz = lhs.size();
+        size_t rsz = rhs.size();
+        lhs.resize(lsz + rsz, 0);
+
+        // From the top down, so every limb of lhs is read before its
+        // slot is reused for the product.
+        Wide base = radix.Base();
+        for (size_t i = lsz; i-- > 0;) {
+            Wide x = lhs[i];
+            lhs[i] = 0;
+            if (x == 0) {
+                continue;
+            }
+            Limb *row = lhs.data() + i;
+            Wide carry = 0;
+            for (size_t j = 0; j < rsz; j++) {
+                Wide cur = x * rhs[j] + row[j] + carry;
+                row[j] = radix.Low(cur);
+                carry = radix.High(cur);
+            }
+            for (size_t k = i + rsz; carry; k++) {
+                Wide cur = Wide(lhs[k]) + carry;
+                carry = (cur >= base);
+                lhs[k] = Limb(carry ? cur - base : cur);
+            }
+        }
+        Trim(lhs);
+    }
+
+    void AddMul(Limbs &a, const Limbs &b, const Limbs &c,
+                const Radix &radix) {
+        if (b.empty() || c.empty()) {
+            return;
+        }
+        if (std::min(b.size(), c.size()) >= kKaratsubaThreshold) {
+            AddShifted(a, Multiply(b, c, radix), 0, radix);
+            Trim(a);
+            return;
+        }
+
+        size_t bsz = b.size();
+        size_t csz = c.size();
+        a.resize(std::max(a.size(), bsz + csz) + 1, 0);
+
+        Wide base = radix.Base();
+        for (size_t i = 0; i < bsz; i++) {
+            Wide x = b[i];
+            if (x == 0) {
+                continue;
+            }
+            Limb *row = a.data() + i;
+            Wide carry = 0;
+            for (size_t j = 0; j < csz; j++) {
+                Wide cur = x * c[j] + row[j] + carry;
+                row[j] = radix.Low(cur);
+                carry = radix.High(cur);
+            }
+            for (size_t k = csz; carry; k++) {
+                Wide cur = Wide(row[k]) + carry;
+                carry = (cur >= base);
+                row[k] = Limb(carry ? cur - base : cur);
+            }
+        }
+        Trim(a);
+    }
+
+    bool SubMul(Limbs &a, const Limbs &b, const Limbs &c,
+                const Radix &radix) {
+        if (b.empty() || c.empty()) {
+            return false;
+        }
+        if (std::min(b.size(), c.size()) >= kKaratsubaThreshold) {
+            Limbs product = Multiply(b, c, radix);
+            Trim(a);
+            if (Compare(a, product) >= 0) {
+                magnitude::SubInPlace(a, product, radix);
+                Trim(a);
+                return false;
+            }
+            magnitude::ReverseSub(a, product, radix);
+            Trim(a);
+            return true;
+        }
+
+        size_t bsz = b.size();
+        size_t csz = c.size();
+        size_t n = std::max(a.size(), bsz + csz);
+        a.resize(n, 0);
+
+        // Every row is subtracted modulo base^n. |a - b * c| < base^n,
+        // so a borrow out of the top limb means the difference is
+        // negative and a holds base^n minus its magnitude.
+        Wide base = radix.Base();
+        bool negative = false;
+        for (size_t i = 0; i < bsz; i++) {
+            Wide x = b[i];
+            if (x == 0) {
+                continue;
+            }
+            Limb *row = a.data() + i;
+            Wide borrow = 0;
+            for (size_t j = 0; j < csz; j++) {
+                Wide cur = x * c[j] + borrow;
+                Limb low = radix.Low(cur);
+                borrow = radix.High(cur) + (row[j] < low);
+                row[j] = Limb(row[j] < low ? row[j] + base - low
+                                           : row[j] - low);
+            }
+            for (size_t k = i + csz; borrow && k < n; k++) {
+                Limb low = radix.Low(borrow);
+                borrow = radix.High(borrow) + (a[k] < low);
+                a[k] = Limb(borrow ? a[k] + base - low : a[k] - low);
+            }
+            negative |= (borrow != 0);
+        }
+
+        if (negative) {
+            Complement(a, radix);
+        }
+        Trim(a);
+        return negative;
+    }
+
+    ProductSum::ProductSum(const Radix &radix) : radix(radix) {}
+
+    void ProductSum::Add(const Limbs &lhs, const Limbs &rhs, int sign) {
+        if (lhs.empty() || rhs.empty() || sign == 0) {
+            return;
+        }
+        if (counters.size() < lhs.size() + rhs.size()) {
+            counters.resize(lhs.size() + rhs.size(), 0);
+        }
+        if (std::min(lhs.size(), rhs.size()) >= kKaratsubaThreshold) {
+            Limbs product = Multiply(lhs, rhs, radix);
+            for (size_t k = 0; k < product.size(); k++) {
+                counters[k] += (sign > 0 ? Counter(product[k])
+                                         : -Counter(product[k]));
+            }
+            return;
+        }
+
+        for (size_t i = 0; i < lhs.size(); i++) {
+            Wide x = lhs[i];
+            if (x == 0) {
+                continue;
+            }
+            Counter *row = counters.data() + i;
+            if (sign > 0) {
+                for (size_t j = 0; j < rhs.size(); j++) {
+                    row[j] += x * rhs[j];
+                }
+            } else {
+                for (size_t j = 0; j < rhs.size(); j++) {
+                    row[j] -= x * rhs[j];
+                }
+            }
+        }
+    }
+
+    Limbs ProductSum::Finish(int &sign) const {
+        // Limbs in [0, base) and a carry rounded toward minus infinity,
+        // so a negative sum ends with a negative carry.
+        Limbs res(counters.size(), 0);
+        Counter carry = 0;
+        for (size_t k = 0; k < counters.size(); k++) {
+            Counter cur = counters[k] + carry;
+            if (cur >= 0) {
+                res[k] = radix.Low(DoubleWide(cur));
+                carry = Counter(radix.High(DoubleWide(cur)));
+                continue;
+            }
+            DoubleWide abs = -DoubleWide(cur);
+            Limb low = radix.Low(abs);
+            DoubleWide high = radix.High(abs);
+            if (low) {
+                low = Limb(radix.Base() - low);
+                high++;
+            }
+            res[k] = low;
+            carry = -Counter(high);
+        }
+
+        // The sum is carry * base^n + res, its magnitude for a negative
+        // carry is (-carry - 1) * base^n + (base^n - res).
+        sign = 1;
+        if (carry < 0) {
+            sign = -1;
+            carry = -carry;
+            if (Complement(res, radix)) {
+                carry--;
+            }
+        }
+        while (carry) {
+            res.push_back(radix.Low(DoubleWide(carry)));
+            carry = Counter(radix.High(DoubleWide(carry)));
+        }
+        Trim(res);
+        if (res.empty()) {
+            sign = 0;
+        }
+        return res;
+    }
+
+    Limbs MultiplySchoolbook(const Limbs &lhs, const Limbs &rhs,
+                             const Radix &radix) {
+        if (lhs.empty() || rhs.empty()) {
+            return {};
+        }
+
+        size_t lsz = lhs.size();
+        size_t rsz = rhs.size();
+        Limbs res(lsz + rsz, 0);
+
+        // The carry is folded into the multiply-add loop, every step fits
+        // into Wide as (base - 1)^2 + 2 (base - 1) < base^2.
+        for (size_t i = 0; i < lsz; i++) {
+            Wide x = lhs[i];
+            if (x == 0) {
+                continue;
+            }
+            Limb *row = res.data() + i;
+            Wide carry = 0;
+            for (size_t j = 0; j < rsz; j++) {
+                Wide cur = x * rhs[j] + row[j] + carry;
+                row[j] = radix.Low(cur);
+                carry = radix.High(cur);
+            }
+            row[rsz] = Limb(carry);
+        }
+        Trim(res);
+
+        return res;
+    }
+
+    Limbs MultiplyKaratsuba(const Limbs &lhs, const Limbs &rhs,
+                            const Radix &radix) {
+        size_t half = (std::max(lhs.size(), rhs.size()) + 1) / 2;
+
+        Limbs l0 = Slice(lhs, 0, half), l1 = Slice(lhs, half, half);
+        Limbs r0 = Slice(rhs, 0, half), r1 = Slice(rhs, half, half);
+
+        Limbs z0 = Multiply(l0, r0, radix);
+        Limbs z2 = Multiply(l1, r1, radix);
+        Limbs z1 = Multiply(Add(l0, l1, radix), Add(r0, r1, radix), radix);
+        z1 = Sub(Sub(z1, z0, radix), z2, radix);
+
+        Limbs res;
+        AddShifted(res, z0, 0, radix);
+        AddShifted(res, z1, half, radix);
+        AddShifted(res, z2, 2 * half, radix);
+        Trim(res);
+
+        return res;
+    }
+
+    Limbs MultiplyToomCook3(const Limbs &lhs, const Limbs &rhs,
+                            const Radix &radix) {
+        size_t part = (std::max(lhs.size(), rhs.size()) + 2) / 3;
+
+        std::vector<SignedLimbs> l = ToomCook3Evaluate(
+                Slice(lhs, 0, part), Slice(lhs, part, part),
+                Slice(lhs, 2 * part, part), radix);
+        std::vector<SignedLimbs> r = ToomCook3Evaluate(
+                Slice(rhs, 0, part), Slice(rhs, part, part),
+                Slice(rhs, 2 * part, part), radix);
+
+        std::vector<SignedLimbs> v(l.size());
+        ForRange(PoolFor(std::min(lhs.size(), rhs.size())), v.size(), 1,
+                 [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                v[i] = MultiplySigned(l[i], r[i], radix);
+            }
+        });
+        const SignedLimbs &v0 = v[0], &v1 = v[1], &vm1 = v[2],
+                          &vm2 = v[3], &vinf = v[4];
+
+        // Bodrato's interpolation sequence; every division is exact.
+        SignedLimbs c3 = SubSigned(vm2, v1, radix);
+        DivideBySmall(c3.magnitude, 3, radix);
+        SignedLimbs c1 = SubSigned(v1, vm1, radix);
+        DivideBySmall(c1.magnitude, 2, radix);
+        SignedLimbs c2 = SubSigned(vm1, v0, radix);
+        c3 = SubSigned(c2, c3, radix);
+        DivideBySmall(c3.magnitude, 2, radix);
+        SignedLimbs twice_vinf = vinf;
+        MulSmall(twice_vinf.magnitude, 2, radix);
+        c3 = AddSigned(c3, twice_vinf, radix);
+        c2 = SubSigned(AddSigned(c2, c1, radix), vinf, radix);
+        c1 = SubSigned(c1, c3, radix);
+
+        Limbs res;
+        AddShifted(res, v0.magnitude, 0, radix);
+        AddShifted(res, c1.magnitude, part, radix);
+        AddShifted(res, c2.magnitude, 2 * part, radix);
+        AddShifted(res, c3.magnitude, 3 * part, radix);
+        AddShifted(res, vinf.magnitude, 4 * part, radix);
+        Trim(res);
+
+        return res;
+    }
+
+    Limbs MultiplyNtt(const Limbs &lhs, const Limbs &rhs, const Radix &radix) {
+        if (lhs.empty() || rhs.empty()) {
+            return {};
+        }
+        if (lhs.size() + rhs.size() > kMaxNttLength) {
+            throw std::length_error("Operands are too long for NTT");
+        }
+
+        size_t res_len = lhs.size() + rhs.size() - 1;
+        size_t len = 1;
+        while (len < res_len) {
+            len <<= 1;
+        }
+
+        ThreadPool *pool = PoolFor(std::min(lhs.size(), rhs.size()));
+        std::vector<uint32_t> r1 = NttPrime1::Convolve(lhs, rhs, len, pool);
+        std::vector<uint32_t> r2 = NttPrime2::Convolve(lhs, rhs, len, pool);
+        std::vector<uint32_t> r3 = NttPrime3::Convolve(lhs, rhs, len, pool);
+
+        // Every chunk is recombined with its own carry chain, the carries
+        // out of the chunks are then added in order.
+        size_t chunk_len = res_len;
+        if (pool) {
+            chunk_len = std::max(kNttGrain,
+                                 (res_len + 4 * pool->Size() - 1) /
+                                 (4 * pool->Size()));
+        }
+        size_t chunks = (res_len + chunk_len - 1) / chunk_len;
+        std::vector<DoubleWide> carries(chunks);
+        Limbs res(res_len, 0);
+        ForRange(pool, chunks, 1, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; c++) {
+                DoubleWide carry = 0;
+                size_t last = std::min(res_len, (c + 1) * chunk_len);
+                for (size_t i = c * chunk_len; i < last; i++) {
+                    uint64_t x1 = r1[i];
+                    uint64_t t2 = (r2[i] + kM2 - x1 % kM2) % kM2
+                                  * kM1InvModM2 % kM2;
+                    uint64_t x12 = x1 + kM1 * t2;
+                    uint64_t t3 = (r3[i] + kM3 - x12 % kM3) % kM3
+                                  * kM12InvModM3 % kM3;
+                    carry += x12 + DoubleWide(kM1 * kM2) * t3;
+
+                    res[i] = radix.Low(carry);
+                    carry = radix.High(carry);
+                }
+                carries[c] = carry;
+            }
+        });
+
+        DoubleWide carry = 0;
+        for (size_t c = 0; c < chunks; c++) {
+            size_t last = std::min(res_len, (c + 1) * chunk_len);
+            for (size_t i = c * chunk_len; carry && i < last; i++) {
+                carry += res[i];
+                res[i] = radix.Low(carry);
+                carry = radix.High(carry);
+            }
+            carry += carries[c];
+        }
+        while (carry) {
+            res.push_back(radix.Low(carry));
+            carry = radix.High(carry);
+        }
+        Trim(res);
+
+        return res;
+    }
+
+}  // namespace multiplication
+
+}  // namespace big_num_arithmetic
@@ -0,0 +1,81 @@
+#ifndef MULTIPLICATION_H_
+#define MULTIPLICATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "magnitude.h"
+
+namespace big_num_arithmetic {
+
+namespace multiplication {
+
+using Limbs = magnitude::Limbs;
+using magnitude::Radix;
+
+// Operands shorter than the threshold (in limbs) fall back to the
+// previous algorithm.
+constexpr size_t kKaratsubaThreshold = 32;
+constexpr size_t kToomCook3Threshold = 160;
+constexpr size_t kDefaultNttThreshold = 1024;
+
+// Products whose shorter operand has at least this many limbs split
+// their work across the thread pool of the calling thread, see
+// CurrentThreadPool, and stay serial below it.
+constexpr size_t kParallelThreshold = 4'096;
+
+// Longest product the three-prime NTT can compute exactly for any radix.
+constexpr size_t kMaxNttLength = size_t(1) << 25;
+
+// Operands with at least this many limbs are multiplied with the NTT.
+// The setting only applies to the calling thread.
+void SetNttThreshold(size_t limbs);
+size_t GetNttThreshold();
+
+// Picks the algorithm by operand size.
+Limbs Multiply(const Limbs &lhs, const Limbs &rhs, const Radix &radix);
+// lhs *= rhs, short operands are multiplied inside lhs's own storage.
+void MultiplyInPlace(Limbs &lhs, const Limbs &rhs, const Radix &radix);
+
+// a += b * c and a -= b * c, short operands are multiplied straight
+// into the limbs of a, longer ones go through Multiply. SubMul returns
+// whether b * c was the larger one, a then holds b * c - a. Neither b
+// nor c may be a.
+void AddMul(Limbs &a, const Limbs &b, const Limbs &c, const Radix &radix);
+bool SubMul(Limbs &a, const Limbs &b, const Limbs &c, const Radix &radix);
+
+// A sum of signed products kept as one signed 128-bit counter per
+// result limb, so the carries are propagated once, by Finish. A limb
+// product adds less than 2^64 to a counter, which leaves room for 2^63
+// of them.
+class ProductSum {
+ public:
+    explicit ProductSum(const Radix &radix);
+
+    // += sign * lhs * rhs
+    void Add(const Limbs &lhs, const Limbs &rhs, int sign);
+
+    // The magnitude of the sum, its sign goes to sign.
+    Limbs Finish(int &sign) const;
+
+ private:
+    using Counter = __int128;
+
+    Radix radix;
+    std::vector<Counter> counters;
+};
+
+Limbs MultiplySchoolbook(const Limbs &lhs, const Limbs &rhs,
+                         const Radix &radix);
+Limbs MultiplyKaratsuba(const Limbs &lhs, const Limbs &rhs,
+                        const Radix &radix);
+Limbs MultiplyToomCook3(const Limbs &lhs, const Limbs &rhs,
+                        const Radix &radix);
+Limbs MultiplyNtt(const Limbs &lhs, const Limbs &rhs,
+                  const Radix &radix);
+
+}  // namespace multiplication
+
+}  // namespace big_num_arithmetic
+
+#endif  // MULTIPLICATION_H_
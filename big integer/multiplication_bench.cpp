@@ -0,0 +1,102 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+#include "multiplication.h"
+#include "thread_pool.h"
+
+using big_num_arithmetic::multiplication::Limbs;
+using big_num_arithmetic::multiplication::Radix;
+
+namespace {
+
+Limbs GenLimbs(size_t size, int64_t base, std::mt19937 &mt) {
+    std::uniform_int_distribution<int64_t> dist(1, base - 1);
+    Limbs limbs(size);
+    for (auto &x : limbs) {
+        x = dist(mt);
+    }
+    return limbs;
+}
+
+// Average time of one call in milliseconds.
+template <typename Function>
+double Measure(Function function) {
+    using Clock = std::chrono::steady_clock;
+
+    int runs = 0;
+    Clock::duration total{};
+    while (runs < 3 || total < std::chrono::milliseconds(200)) {
+        auto start = Clock::now();
+        function();
+        total += Clock::now() - start;
+        runs++;
+    }
+    return std::chrono::duration<double, std::milli>(total).count() / runs;
+}
+
+}  // namespace
+
+// Compares the Karatsuba/Toom-Cook path with the NTT for equal-sized
+// operands, and the NTT split across a pool of threads when given,
+// usage: multiplication_bench [base] [max limbs] [threads].
+int main(int argc, char **argv) {
+    namespace mult = big_num_arithmetic::multiplication;
+
+    int64_t base = (argc > 1 ? std::stoll(argv[1]) : int64_t(1) << 32);
+    Radix radix(base);
+    size_t max_size = (argc > 2 ? std::stoull(argv[2]) : size_t(1) << 17);
+    size_t threads = (argc > 3 ? std::stoull(argv[3]) : 1);
+    big_num_arithmetic::ThreadPool pool(threads);
+    std::mt19937 mt(42);
+
+    size_t threshold = mult::GetNttThreshold();
+    size_t crossover = 0;
+
+    std::cout << std::setw(10) << "limbs"
+              << std::setw(18) << "toom-cook, ms"
+              << std::setw(14) << "ntt, ms";
+    if (threads > 1) {
+        std::cout << std::setw(16)
+                  << "ntt x" + std::to_string(threads) + ", ms";
+    }
+    std::cout << std::endl;
+
+    for (size_t size = 32; size <= max_size; size *= 2) {
+        Limbs a = GenLimbs(size, base, mt);
+        Limbs b = GenLimbs(size, base, mt);
+
+        mult::SetNttThreshold(std::numeric_limits<size_t>::max());
+        double toom = Measure([&] { mult::Multiply(a, b, radix); });
+        double ntt = Measure([&] { mult::MultiplyNtt(a, b, radix); });
+
+        if (ntt < toom && !crossover) {
+            crossover = size;
+        }
+        std::cout << std::setw(10) << size
+                  << std::setw(18) << std::fixed << std::setprecision(3)
+                  << toom
+                  << std::setw(14) << ntt;
+        if (threads > 1) {
+            big_num_arithmetic::ScopedThreadPool scope(&pool);
+            std::cout << std::setw(16)
+                      << Measure([&] { mult::MultiplyNtt(a, b, radix); });
+        }
+        std::cout << std::endl;
+    }
+    mult::SetNttThreshold(threshold);
+
+    if (crossover) {
+        std::cout << "NTT is faster from about " << crossover / 2
+                  << " to " << crossover << " limbs (current threshold "
+                  << threshold << ")" << std::endl;
+    } else {
+        std::cout << "NTT is never faster up to " << max_size
+                  << " limbs" << std::endl;
+    }
+    return 0;
+}
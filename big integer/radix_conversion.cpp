@@ -0,0 +1,442 @@
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+#include "division.h"
+#include "multiplication.h"
+#include "radix_conversion.h"
+#include "thread_pool.h"
+
+namespace big_num_arithmetic {
+
+namespace radix_conversion {
+
+namespace {
+
+    using magnitude::Limb;
+    using magnitude::Wide;
+
+    // The largest power of the radix that is still a valid single-limb
+    // multiplier or divisor.
+    struct Chunk {
+        uint64_t value;
+        size_t digits;
+    };
+
+    // chunk^(2^i) for the i-th level.
+    struct Level {
+        Limbs power;
+        size_t digits;
+        std::unique_ptr<division::ReciprocalDivisor> reciprocal;
+    };
+
+    Chunk GetChunk(int radix, const Radix &limb_radix) {
+        Chunk chunk{uint64_t(radix), 1};
+        uint64_t limit = limb_radix.MaxSmall();
+        while (chunk.value <= limit / radix) {
+            chunk.value *= radix;
+            chunk.digits++;
+        }
+        return chunk;
+    }
+
+    // Every thread keeps its own powers, so conversions never write
+    // shared state. The cache outlives any ScopedMemoryResource, its
+    // limbs come from the default heap.
+    std::vector<Level> &GetLevels(int radix, const Radix &limb_radix) {
+        thread_local std::map<std::pair<uint64_t, int>, std::vector<Level>>
+                cache;
+
+        std::vector<Level> &levels = cache[{limb_radix.Base(), radix}];
+        if (levels.empty()) {
+            ScopedMemoryResource heap(std::pmr::new_delete_resource());
+            Chunk chunk = GetChunk(radix, limb_radix);
+            Limbs power = magnitude::FromWord(chunk.value, limb_radix);
+            levels.push_back({power, chunk.digits, nullptr});
+        }
+        return levels;
+    }
+
+    void AddLevel(std::vector<Level> &levels, const Radix &limb_radix) {
+        ScopedMemoryResource heap(std::pmr::new_delete_resource());
+        const Level &top = levels.back();
+        Limbs power = multiplication::Multiply(top.power, top.power,
+                                               limb_radix);
+        size_t digits = 2 * top.digits;
+        levels.push_back({power, digits, nullptr});
+    }
+
+    // Builds the reciprocals of the levels below level up front, so the
+    // recursion only reads the cache.
+    void AddReciprocals(std::vector<Level> &levels, size_t level,
+                        const Radix &limb_radix) {
+        ScopedMemoryResource heap(std::pmr::new_delete_resource());
+        for (size_t i = 0; i < level; i++) {
+            Level &cur = levels[i];
+            if (cur.power.size() >= division::kNewtonThreshold &&
+                !cur.reciprocal) {
+                cur.reciprocal =
+                        std::make_unique<division::ReciprocalDivisor>(
+                                cur.power, limb_radix);
+            }
+        }
+    }
+
+    void DivModByLevel(const Limbs &a, const Level &level,
+                       const Radix &limb_radix,
+                       Limbs &quotient, Limbs &remainder) {
+        if (!level.reciprocal) {
+            division::DivMod(a, level.power, limb_radix, quotient, remainder);
+            return;
+        }
+        level.reciprocal->DivMod(a, quotient, remainder);
+    }
+
+    // Emits chunk.digits digits per single-limb division. Pads the
+    // result with zeros up to width digits.
+    void ToDigitsBasecase(Limbs a, const Chunk &chunk, int radix,
+                          const Radix &limb_radix, size_t width, Digits &out) {
+        Digits reversed;
+        while (!a.empty()) {
+            uint64_t rem = magnitude::DivideBySmall(a, chunk.value,
+                                                    limb_radix);
+            for (size_t i = 0; i < chunk.digits; i++) {
+                reversed.push_back(rem % radix);
+                rem /= radix;
+            }
+        }
+
+        while (!reversed.empty() && reversed.back() == 0) {
+            reversed.pop_back();
+        }
+        if (reversed.size() < width) {
+            reversed.resize(width, 0);
+        }
+        out.insert(out.end(), reversed.rbegin(), reversed.rend());
+    }
+
+    // Requires a < levels[level].power.
+    void ToDigitsRecursive(const Limbs &a, const std::vector<Level> &levels,
+                           size_t level, const Chunk &chunk, int radix,
+                           const Radix &limb_radix, size_t width,
+                           Digits &out) {
+        if (level == 0 || a.size() < kDivideAndConquerThreshold) {
+            ToDigitsBasecase(a, chunk, radix, limb_radix, width, out);
+            return;
+        }
+
+        const Level &half = levels[level - 1];
+        Limbs q, r;
+        DivModByLevel(a, half, limb_radix, q, r);
+
+        if (width == 0 && q.empty()) {
+            ToDigitsRecursive(r, levels, level - 1, chunk, radix, limb_radix,
+                              0, out);
+            return;
+        }
+        ToDigitsRecursive(q, levels, level - 1, chunk, radix, limb_radix,
+                          width ? width - half.digits : 0, out);
+        ToDigitsRecursive(r, levels, level - 1, chunk, radix, limb_radix,
+                          half.digits, out);
+    }
+
+    // Horner's scheme over chunk.digits digits at a time.
+    Limbs FromDigitsBasecase(const uint8_t *first, const uint8_t *last,
+                             const Chunk &chunk, int radix,
+                             const Radix &limb_radix) {
+        Limbs res;
+        auto push = [&res, &limb_radix](uint64_t multiplier,
+                                        uint64_t value) {
+            Wide carry = value;
+            for (Limb &x : res) {
+                Wide cur = Wide(x) * multiplier + carry;
+                x = limb_radix.Low(cur);
+                carry = limb_radix.High(cur);
+            }
+            while (carry) {
+                res.push_back(limb_radix.Low(carry));
+                carry = limb_radix.High(carry);
+            }
+        };
+
+        size_t head = (last - first) % chunk.digits;
+        while (first != last) {
+            size_t count = (head ? head : chunk.digits);
+            head = 0;
+
+            uint64_t multiplier = 1;
+            uint64_t value = 0;
+            for (size_t i = 0; i < count; i++) {
+                multiplier *= radix;
+                value = value * radix + *first++;
+            }
+            push(multiplier, value);
+        }
+        magnitude::Trim(res);
+
+        return res;
+    }
+
+    Limbs FromDigitsRecursive(const uint8_t *first, const uint8_t *last,
+                              const std::vector<Level> &levels,
+                              const Chunk &chunk, int radix,
+                              const Radix &limb_radix) {
+        size_t len = last - first;
+        if (len <= chunk.digits * kDivideAndConquerThreshold) {
+            return FromDigitsBasecase(first, last, chunk, radix, limb_radix);
+        }
+
+        size_t level = 0;
+        while (level + 1 < levels.size() && levels[level + 1].digits < len) {
+            level++;
+        }
+        const Level &low = levels[level];
+
+        Limbs res = multiplication::Multiply(
+                FromDigitsRecursive(first, last - low.digits, levels, chunk,
+                                    radix, limb_radix),
+                low.power, limb_radix);
+        magnitude::AddShifted(res,
+                              FromDigitsRecursive(last - low.digits, last,
+                                                  levels, chunk, radix,
+                                                  limb_radix),
+                              0, limb_radix);
+        magnitude::Trim(res);
+
+        return res;
+    }
+
+    // Part of the ToDigitsRecursive tree.
+    struct Piece {
+        Limbs a;
+        size_t level;
+        size_t width;
+    };
+
+    // One step of ToDigitsRecursive, false for a piece it converts
+    // directly.
+    bool SplitPiece(Piece &piece, const std::vector<Level> &levels,
+                    const Radix &limb_radix, std::vector<Piece> &out) {
+        if (piece.level == 0 ||
+            piece.a.size() < kDivideAndConquerThreshold) {
+            out.push_back(std::move(piece));
+            return false;
+        }
+
+        const Level &half = levels[piece.level - 1];
+        Limbs q, r;
+        DivModByLevel(piece.a, half, limb_radix, q, r);
+        if (piece.width == 0 && q.empty()) {
+            out.push_back({std::move(r), piece.level - 1, 0});
+            return true;
+        }
+        size_t width = (piece.width ? piece.width - half.digits : 0);
+        out.push_back({std::move(q), piece.level - 1, width});
+        out.push_back({std::move(r), piece.level - 1, half.digits});
+        return true;
+    }
+
+    // The top of the recursion is split a level at a time, all pieces
+    // of a level in parallel, until there are a few pieces per thread.
+    // Those are then converted in parallel. A single huge piece is split
+    // on the calling thread, so its products use the pool themselves.
+    void ToDigitsParallel(Limbs a, const std::vector<Level> &levels,
+                          size_t level, const Chunk &chunk, int radix,
+                          const Radix &limb_radix, ThreadPool &pool,
+                          Digits &out) {
+        std::vector<Piece> pieces;
+        pieces.push_back({std::move(a), level, 0});
+        while (pieces.size() < 4 * pool.Size()) {
+            std::vector<std::vector<Piece>> parts(pieces.size());
+            std::vector<char> split(pieces.size());
+            pool.ParallelFor(pieces.size(), 1,
+                             [&](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; i++) {
+                    split[i] = SplitPiece(pieces[i], levels, limb_radix,
+                                          parts[i]);
+                }
+            });
+
+            pieces.clear();
+            for (auto &part : parts) {
+                for (auto &piece : part) {
+                    pieces.push_back(std::move(piece));
+                }
+            }
+            if (std::count(split.begin(), split.end(), 1) == 0) {
+                break;
+            }
+        }
+
+        std::vector<Digits> digits(pieces.size());
+        pool.ParallelFor(pieces.size(), 1,
+                         [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                ToDigitsRecursive(pieces[i].a, levels, pieces[i].level, chunk,
+                                  radix, limb_radix, pieces[i].width,
+                                  digits[i]);
+            }
+        });
+        for (const Digits &part : digits) {
+            out.insert(out.end(), part.begin(), part.end());
+        }
+    }
+
+    // A node of the FromDigitsRecursive tree, an inner one is worth
+    // value(high) * levels[level].power + value(low).
+    struct Node {
+        const uint8_t *first;
+        const uint8_t *last;
+        bool leaf;
+        size_t level;
+        size_t high;
+        size_t low;
+        Limbs value;
+    };
+
+    // The tree is unfolded breadth first until there are a few leaves
+    // per thread. Leaves are converted in parallel, and then every
+    // depth of inner nodes bottom up, the root on the calling thread.
+    Limbs FromDigitsParallel(const uint8_t *first, const uint8_t *last,
+                             const std::vector<Level> &levels,
+                             const Chunk &chunk, int radix,
+                             const Radix &limb_radix, ThreadPool &pool) {
+        std::vector<Node> nodes;
+        nodes.push_back({first, last, true, 0, 0, 0, {}});
+        std::vector<std::vector<size_t>> depths;
+        std::vector<size_t> frontier{0};
+        size_t leaves = 1;
+        while (!frontier.empty() && leaves < 4 * pool.Size()) {
+            std::vector<size_t> inner, next;
+            for (size_t id : frontier) {
+                size_t len = nodes[id].last - nodes[id].first;
+                if (len <= chunk.digits * kDivideAndConquerThreshold) {
+                    continue;
+                }
+                size_t level = 0;
+                while (level + 1 < levels.size() &&
+                       levels[level + 1].digits < len) {
+                    level++;
+                }
+                const uint8_t *middle = nodes[id].last - levels[level].digits;
+                nodes[id].leaf = false;
+                nodes[id].level = level;
+                nodes[id].high = nodes.size();
+                nodes[id].low = nodes.size() + 1;
+                nodes.push_back({nodes[id].first, middle, true, 0, 0, 0, {}});
+                nodes.push_back({middle, nodes[id].last, true, 0, 0, 0, {}});
+                inner.push_back(id);
+                next.push_back(nodes[id].high);
+                next.push_back(nodes[id].low);
+                leaves++;
+            }
+            if (!inner.empty()) {
+                depths.push_back(std::move(inner));
+            }
+            frontier = std::move(next);
+        }
+
+        std::vector<size_t> leaf_ids;
+        for (size_t id = 0; id < nodes.size(); id++) {
+            if (nodes[id].leaf) {
+                leaf_ids.push_back(id);
+            }
+        }
+        pool.ParallelFor(leaf_ids.size(), 1,
+                         [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                Node &node = nodes[leaf_ids[i]];
+                node.value = FromDigitsRecursive(node.first, node.last,
+                                                 levels, chunk, radix,
+                                                 limb_radix);
+            }
+        });
+
+        for (size_t d = depths.size(); d-- > 0;) {
+            const std::vector<size_t> &ids = depths[d];
+            pool.ParallelFor(ids.size(), 1,
+                             [&](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; i++) {
+                    Node &node = nodes[ids[i]];
+                    Limbs res = multiplication::Multiply(
+                            nodes[node.high].value,
+                            levels[node.level].power, limb_radix);
+                    magnitude::AddShifted(res, nodes[node.low].value, 0,
+                                          limb_radix);
+                    magnitude::Trim(res);
+                    node.value = std::move(res);
+                    nodes[node.high].value = Limbs();
+                    nodes[node.low].value = Limbs();
+                }
+            });
+        }
+        return std::move(nodes[0].value);
+    }
+
+}  // namespace
+
+    Digits ToDigits(const Limbs &a, int radix, const Radix &limb_radix) {
+        Limbs trimmed(a);
+        magnitude::Trim(trimmed);
+
+        Chunk chunk = GetChunk(radix, limb_radix);
+        Digits out;
+        if (trimmed.size() < kDivideAndConquerThreshold) {
+            ToDigitsBasecase(trimmed, chunk, radix, limb_radix, 0, out);
+            return out;
+        }
+
+        std::vector<Level> &levels = GetLevels(radix, limb_radix);
+        while (levels.back().power.size() <= trimmed.size()) {
+            AddLevel(levels, limb_radix);
+        }
+        size_t level = 0;
+        while (levels[level].power.size() <= trimmed.size()) {
+            level++;
+        }
+        AddReciprocals(levels, level, limb_radix);
+
+        ThreadPool *pool = CurrentThreadPool();
+        if (pool && pool->Size() > 1 &&
+            trimmed.size() >= kParallelConversionThreshold) {
+            ToDigitsParallel(std::move(trimmed), levels, level, chunk, radix,
+                             limb_radix, *pool, out);
+            return out;
+        }
+        ToDigitsRecursive(trimmed, levels, level, chunk, radix, limb_radix, 0,
+                          out);
+        return out;
+    }
+
+    Limbs FromDigits(const Digits &digits, int radix,
+                     const Radix &limb_radix) {
+        const uint8_t *first = digits.data();
+        const uint8_t *last = first + digits.size();
+        while (first != last && *first == 0) {
+            first++;
+        }
+
+        Chunk chunk = GetChunk(radix, limb_radix);
+        if (size_t(last - first) <= chunk.digits * kDivideAndConquerThreshold) {
+            return FromDigitsBasecase(first, last, chunk, radix, limb_radix);
+        }
+
+        std::vector<Level> &levels = GetLevels(radix, limb_radix);
+        while (levels.back().digits < size_t(last - first)) {
+            AddLevel(levels, limb_radix);
+        }
+
+        ThreadPool *pool = CurrentThreadPool();
+        if (pool && pool->Size() > 1 &&
+            size_t(last - first) >= chunk.digits *
+                                    kParallelConversionThreshold) {
+            return FromDigitsParallel(first, last, levels, chunk, radix,
+                                      limb_radix, *pool);
+        }
+        return FromDigitsRecursive(first, last, levels, chunk, radix,
+                                   limb_radix);
+    }
+
+}  // namespace radix_conversion
+
+}  // namespace big_num_arithmetic
@@ -0,0 +1,38 @@
+#ifndef RADIX_CONVERSION_H_
+#define RADIX_CONVERSION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "magnitude.h"
+
+namespace big_num_arithmetic {
+
+namespace radix_conversion {
+
+using Limbs = magnitude::Limbs;
+using magnitude::Radix;
+
+// Digit values, the most significant first.
+using Digits = std::vector<uint8_t>;
+
+// Numbers shorter than this (in limbs) are converted chunk by chunk,
+// longer ones are split by cached powers of the radix.
+constexpr size_t kDivideAndConquerThreshold = 40;
+
+// Numbers of at least this many limbs are converted across the thread
+// pool of the calling thread, see CurrentThreadPool.
+constexpr size_t kParallelConversionThreshold = 4'096;
+
+// No leading zeros, zero has no digits.
+Digits ToDigits(const Limbs &a, int radix, const Radix &limb_radix);
+
+// Leading zeros are allowed.
+Limbs FromDigits(const Digits &digits, int radix,
+                 const Radix &limb_radix);
+
+}  // namespace radix_conversion
+
+}  // namespace big_num_arithmetic
+
+#endif  // RADIX_CONVERSION_H_
@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "serialization.h"
+
+namespace big_num_arithmetic {
+
+namespace serialization {
+
+using magnitude::Limb;
+
+namespace {
+
+    constexpr bool kLittleEndian =
+            __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+
+    constexpr uint64_t kSignBit = uint64_t(1) << 63;
+
+    // Longest value whose byte size still fits into size_t.
+    constexpr size_t kMaxWords =
+            (std::numeric_limits<size_t>::max() - kHeaderBytes) / kWordBytes;
+
+    // A corrupt header must not make the stream reader allocate
+    // everything at once, so it grows the words this many at a time.
+    constexpr size_t kStreamPiece = size_t(1) << 20;
+
+    void StoreHeader(size_t count, bool negative, char *out) {
+        uint64_t header = count | (negative ? kSignBit : 0);
+        for (size_t i = 0; i < kHeaderBytes; i++) {
+            out[i] = char(header >> (8 * i));
+        }
+    }
+
+    // Throws unless the header describes a value that may exist.
+    void LoadHeader(const char *data, size_t &count, bool &negative) {
+        uint64_t header = 0;
+        for (size_t i = 0; i < kHeaderBytes; i++) {
+            header |= uint64_t(uint8_t(data[i])) << (8 * i);
+        }
+        negative = (header & kSignBit);
+        if ((header & ~kSignBit) > kMaxWords) {
+            throw std::runtime_error("Malformed serialized integer");
+        }
+        count = size_t(header & ~kSignBit);
+        if (negative && count == 0) {
+            throw std::runtime_error("Malformed serialized integer");
+        }
+    }
+
+    Limb LoadWord(const char *data) {
+        Limb word;
+        if (kLittleEndian) {
+            std::memcpy(&word, data, kWordBytes);
+            return word;
+        }
+        word = 0;
+        for (size_t i = 0; i < kWordBytes; i++) {
+            word |= Limb(uint8_t(data[i])) << (8 * i);
+        }
+        return word;
+    }
+
+    void StoreWords(const Limb *words, size_t count, char *out) {
+        if (kLittleEndian) {
+            std::memcpy(out, words, count * kWordBytes);
+            return;
+        }
+        for (size_t i = 0; i < count; i++) {
+            for (size_t j = 0; j < kWordBytes; j++) {
+                out[i * kWordBytes + j] = char(words[i] >> (8 * j));
+            }
+        }
+    }
+
+    void CheckTrimmed(const Limbs &words) {
+        if (!words.empty() && words.back() == 0) {
+            throw std::runtime_error("Malformed serialized integer");
+        }
+    }
+
+}  // namespace
+
+    size_t ByteSize(size_t words) {
+        return kHeaderBytes + words * kWordBytes;
+    }
+
+    size_t Write(const Limbs &words, bool negative, char *out) {
+        StoreHeader(words.size(), negative && !words.empty(), out);
+        StoreWords(words.data(), words.size(), out + kHeaderBytes);
+        return ByteSize(words.size());
+    }
+
+    void Write(const Limbs &words, bool negative, std::ostream &out) {
+        char header[kHeaderBytes];
+        StoreHeader(words.size(), negative && !words.empty(), header);
+        out.write(header, kHeaderBytes);
+        if (kLittleEndian) {
+            out.write(reinterpret_cast<const char *>(words.data()),
+                      words.size() * kWordBytes);
+            return;
+        }
+        char buffer[kWordBytes];
+        for (Limb word : words) {
+            StoreWords(&word, 1, buffer);
+            out.write(buffer, kWordBytes);
+        }
+    }
+
+    Limbs Read(std::istream &in, bool &negative) {
+        char header[kHeaderBytes];
+        if (!in.read(header, kHeaderBytes)) {
+            throw std::runtime_error("Truncated serialized integer");
+        }
+        size_t count;
+        LoadHeader(header, count, negative);
+
+        Limbs words;
+        for (size_t done = 0; done < count;) {
+            size_t piece = std::min(count - done, kStreamPiece);
+            words.resize(done + piece);
+            char *to = reinterpret_cast<char *>(words.data() + done);
+            if (!in.read(to, piece * kWordBytes)) {
+                throw std::runtime_error("Truncated serialized integer");
+            }
+            if (!kLittleEndian) {
+                for (size_t i = done; i < done + piece; i++) {
+                    words[i] = LoadWord(reinterpret_cast<char *>(&words[i]));
+                }
+            }
+            done += piece;
+        }
+        CheckTrimmed(words);
+        return words;
+    }
+
+    Limbs ReadWords(const char *data, size_t count) {
+        Limbs words(count);
+        if (kLittleEndian) {
+            std::memcpy(words.data(), data, count * kWordBytes);
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                words[i] = LoadWord(data + i * kWordBytes);
+            }
+        }
+        return words;
+    }
+
+}  // namespace serialization
+
+    BigIntegerView BigIntegerView::Parse(const char *data, size_t size) {
+        if (size < serialization::kHeaderBytes) {
+            throw std::runtime_error("Truncated serialized integer");
+        }
+        size_t count;
+        bool negative;
+        serialization::LoadHeader(data, count, negative);
+        if ((size - serialization::kHeaderBytes) / serialization::kWordBytes
+                < count) {
+            throw std::runtime_error("Truncated serialized integer");
+        }
+
+        BigIntegerView view(data + serialization::kHeaderBytes, count,
+                            negative ? -1 : count ? 1 : 0);
+        if (count && view.Word(count - 1) == 0) {
+            throw std::runtime_error("Malformed serialized integer");
+        }
+        return view;
+    }
+
+    BigIntegerView::BigIntegerView(const char *words, size_t count,
+                                   int sign)
+            : words(words), count(count), sign(sign) {}
+
+    int BigIntegerView::Sign() const {
+        return sign;
+    }
+
+    size_t BigIntegerView::Size() const {
+        return count;
+    }
+
+    uint32_t BigIntegerView::Word(size_t i) const {
+        return serialization::LoadWord(words + i * serialization::kWordBytes);
+    }
+
+    size_t BigIntegerView::ByteSize() const {
+        return serialization::ByteSize(count);
+    }
+
+    const char *BigIntegerView::End() const {
+        return words + count * serialization::kWordBytes;
+    }
+
+    magnitude::Limbs BigIntegerView::Words() const {
+        return serialization::ReadWords(words, count);
+    }
+
+}  // namespace big_num_arithmetic
@@ -0,0 +1,73 @@
+#ifndef SERIALIZATION_H_
+#define SERIALIZATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include "magnitude.h"
+
+namespace big_num_arithmetic {
+
+// Binary format of an integer, the same whatever its base is: an 8 byte
+// little-endian header holding the number of words in its low 63 bits
+// and the sign in the top one, then the magnitude as little-endian 32
+// bit binary words, the last one non-zero. Zero is a header of zero
+// bits. Every value takes a multiple of 4 bytes, so the words of values
+// concatenated into a 4 byte aligned buffer stay aligned.
+namespace serialization {
+
+using Limbs = magnitude::Limbs;
+
+constexpr size_t kHeaderBytes = 8;
+constexpr size_t kWordBytes = 4;
+
+// Bytes taken by a value of that many words.
+size_t ByteSize(size_t words);
+
+// Writes a value of trimmed binary words, the first overload into
+// ByteSize(words.size()) bytes at out, which it returns.
+size_t Write(const Limbs &words, bool negative, char *out);
+void Write(const Limbs &words, bool negative, std::ostream &out);
+
+// Reads the value at the front of the input. Both throw
+// std::runtime_error if it is truncated or malformed.
+Limbs Read(std::istream &in, bool &negative);
+
+// count words at data, which need not be aligned.
+Limbs ReadWords(const char *data, size_t count);
+
+}  // namespace serialization
+
+// A read-only view of one serialized value, for example in a mapped
+// file of many of them. The words are read where they lie, nothing is
+// copied.
+class BigIntegerView {
+ public:
+    // The value at the front of [data, data + size). Throws
+    // std::runtime_error if it is truncated or malformed.
+    static BigIntegerView Parse(const char *data, size_t size);
+
+    int Sign() const;
+    // Number of binary words of the magnitude.
+    size_t Size() const;
+    // Word i of the magnitude, the least significant first.
+    uint32_t Word(size_t i) const;
+
+    // Bytes of the value, and where the next value starts.
+    size_t ByteSize() const;
+    const char *End() const;
+
+    magnitude::Limbs Words() const;
+
+ private:
+    BigIntegerView(const char *words, size_t count, int sign);
+
+    const char *words;
+    size_t count;
+    int sign;
+};
+
+}  // namespace big_num_arithmetic
+
+#endif  // SERIALIZATION_H_
@@ -0,0 +1,290 @@
+#include "simd.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BIG_NUM_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace big_num_arithmetic {
+
+namespace simd {
+
+namespace {
+
+    using magnitude::Wide;
+
+    Limb AddScalar(Limb *dst, const Limb *a, const Limb *b, size_t n,
+                   Limb carry, const Radix &radix) {
+        Wide base = radix.Base();
+        Wide c = carry;
+        for (size_t i = 0; i < n; i++) {
+            Wide cur = Wide(a[i]) + b[i] + c;
+            c = (cur >= base);
+            dst[i] = Limb(c ? cur - base : cur);
+        }
+        return Limb(c);
+    }
+
+    Limb SubScalar(Limb *dst, const Limb *a, const Limb *b, size_t n,
+                   Limb borrow, const Radix &radix) {
+        int64_t base = radix.Base();
+        int64_t c = borrow;
+        for (size_t i = 0; i < n; i++) {
+            int64_t cur = int64_t(a[i]) - b[i] - c;
+            c = (cur < 0);
+            dst[i] = Limb(c ? cur + base : cur);
+        }
+        return Limb(c);
+    }
+
+    int CompareScalar(const Limb *a, const Limb *b, size_t n) {
+        for (size_t i = n; i-- > 0;) {
+            if (a[i] != b[i]) {
+                return a[i] < b[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+#ifdef BIG_NUM_X86_SIMD
+
+    // Each block of lanes yields two bit masks: lanes that produce a
+    // carry on their own and lanes that only pass an incoming carry on.
+    // Adding them as binary numbers resolves the whole carry chain of
+    // the block at once.
+    struct CarryBits {
+        unsigned in;
+        unsigned out;
+        Limb next;
+    };
+
+    inline CarryBits ResolveCarries(unsigned generate, unsigned propagate,
+                                    Limb carry, int lanes) {
+        unsigned sum = ((generate | propagate) + generate + carry);
+        unsigned carries = sum ^ propagate;
+        unsigned mask = (1u << lanes) - 1;
+        return {carries & mask, (carries >> 1) & mask,
+                Limb((sum >> lanes) & 1)};
+    }
+
+    // Wider bases can overflow a 32-bit lane sum.
+    constexpr uint64_t kMaxLaneBase = uint64_t(1) << 31;
+
+    __attribute__((target("avx2")))
+    __m256i ExpandAvx2(unsigned mask) {
+        const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        __m256i v = _mm256_and_si256(_mm256_set1_epi32(mask), bits);
+        return _mm256_cmpeq_epi32(v, bits);
+    }
+
+    __attribute__((target("avx2")))
+    unsigned MaskAvx2(__m256i v) {
+        return _mm256_movemask_ps(_mm256_castsi256_ps(v));
+    }
+
+    __attribute__((target("avx2")))
+    Limb AddAvx2(Limb *dst, const Limb *a, const Limb *b, size_t n,
+                 Limb carry, const Radix &radix) {
+        bool binary = (radix.Base() == kMaxLaneBase * 2);
+        if (!binary && radix.Base() > kMaxLaneBase) {
+            return AddScalar(dst, a, b, n, carry, radix);
+        }
+
+        const __m256i ones = _mm256_set1_epi32(-1);
+        const __m256i vbase = _mm256_set1_epi32(Limb(radix.Base()));
+        const __m256i vmax = _mm256_set1_epi32(Limb(radix.Base() - 1));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+            __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+            __m256i s = _mm256_add_epi32(va, vb);
+
+            // s >= base, a wrapped sum for the binary base.
+            __m256i g = (binary
+                    ? _mm256_xor_si256(_mm256_cmpeq_epi32(
+                              _mm256_max_epu32(s, va), s), ones)
+                    : _mm256_cmpeq_epi32(_mm256_max_epu32(s, vbase), s));
+            __m256i p = _mm256_cmpeq_epi32(s, vmax);
+
+            CarryBits c = ResolveCarries(MaskAvx2(g), MaskAvx2(p), carry, 8);
+            carry = c.next;
+
+            s = _mm256_sub_epi32(s, ExpandAvx2(c.in));
+            if (!binary) {
+                s = _mm256_sub_epi32(
+                        s, _mm256_and_si256(ExpandAvx2(c.out), vbase));
+            }
+            _mm256_storeu_si256((__m256i *)(dst + i), s);
+        }
+        return AddScalar(dst + i, a + i, b + i, n - i, carry, radix);
+    }
+
+    __attribute__((target("avx2")))
+    Limb SubAvx2(Limb *dst, const Limb *a, const Limb *b, size_t n,
+                 Limb borrow, const Radix &radix) {
+        bool binary = (radix.Base() == kMaxLaneBase * 2);
+        const __m256i ones = _mm256_set1_epi32(-1);
+        const __m256i vbase = _mm256_set1_epi32(Limb(radix.Base()));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+            __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+            __m256i d = _mm256_sub_epi32(va, vb);
+
+            // a < b and a == b
+            __m256i g = _mm256_xor_si256(_mm256_cmpeq_epi32(
+                    _mm256_max_epu32(va, vb), va), ones);
+            __m256i p = _mm256_cmpeq_epi32(va, vb);
+
+            CarryBits c = ResolveCarries(MaskAvx2(g), MaskAvx2(p), borrow, 8);
+            borrow = c.next;
+
+            d = _mm256_add_epi32(d, ExpandAvx2(c.in));
+            if (!binary) {
+                d = _mm256_add_epi32(
+                        d, _mm256_and_si256(ExpandAvx2(c.out), vbase));
+            }
+            _mm256_storeu_si256((__m256i *)(dst + i), d);
+        }
+        return SubScalar(dst + i, a + i, b + i, n - i, borrow, radix);
+    }
+
+    __attribute__((target("avx2")))
+    int CompareAvx2(const Limb *a, const Limb *b, size_t n) {
+        size_t i = n;
+        while (i >= 8) {
+            i -= 8;
+            __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+            __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+            unsigned diff = ~MaskAvx2(_mm256_cmpeq_epi32(va, vb)) & 0xFF;
+            if (diff) {
+                size_t lane = i + 31 - __builtin_clz(diff);
+                return a[lane] < b[lane] ? -1 : 1;
+            }
+        }
+        return CompareScalar(a, b, i);
+    }
+
+    __attribute__((target("sse4.1")))
+    __m128i ExpandSse(unsigned mask) {
+        const __m128i bits = _mm_setr_epi32(1, 2, 4, 8);
+        __m128i v = _mm_and_si128(_mm_set1_epi32(mask), bits);
+        return _mm_cmpeq_epi32(v, bits);
+    }
+
+    __attribute__((target("sse4.1")))
+    unsigned MaskSse(__m128i v) {
+        return _mm_movemask_ps(_mm_castsi128_ps(v));
+    }
+
+    __attribute__((target("sse4.1")))
+    Limb AddSse(Limb *dst, const Limb *a, const Limb *b, size_t n,
+                Limb carry, const Radix &radix) {
+        bool binary = (radix.Base() == kMaxLaneBase * 2);
+        if (!binary && radix.Base() > kMaxLaneBase) {
+            return AddScalar(dst, a, b, n, carry, radix);
+        }
+
+        const __m128i ones = _mm_set1_epi32(-1);
+        const __m128i vbase = _mm_set1_epi32(Limb(radix.Base()));
+        const __m128i vmax = _mm_set1_epi32(Limb(radix.Base() - 1));
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+            __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+            __m128i s = _mm_add_epi32(va, vb);
+
+            __m128i g = (binary
+                    ? _mm_xor_si128(_mm_cmpeq_epi32(
+                              _mm_max_epu32(s, va), s), ones)
+                    : _mm_cmpeq_epi32(_mm_max_epu32(s, vbase), s));
+            __m128i p = _mm_cmpeq_epi32(s, vmax);
+
+            CarryBits c = ResolveCarries(MaskSse(g), MaskSse(p), carry, 4);
+            carry = c.next;
+
+            s = _mm_sub_epi32(s, ExpandSse(c.in));
+            if (!binary) {
+                s = _mm_sub_epi32(s, _mm_and_si128(ExpandSse(c.out), vbase));
+            }
+            _mm_storeu_si128((__m128i *)(dst + i), s);
+        }
+        return AddScalar(dst + i, a + i, b + i, n - i, carry, radix);
+    }
+
+    __attribute__((target("sse4.1")))
+    Limb SubSse(Limb *dst, const Limb *a, const Limb *b, size_t n,
+                Limb borrow, const Radix &radix) {
+        bool binary = (radix.Base() == kMaxLaneBase * 2);
+        const __m128i ones = _mm_set1_epi32(-1);
+        const __m128i vbase = _mm_set1_epi32(Limb(radix.Base()));
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+            __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+            __m128i d = _mm_sub_epi32(va, vb);
+
+            __m128i g = _mm_xor_si128(_mm_cmpeq_epi32(
+                    _mm_max_epu32(va, vb), va), ones);
+            __m128i p = _mm_cmpeq_epi32(va, vb);
+
+            CarryBits c = ResolveCarries(MaskSse(g), MaskSse(p), borrow, 4);
+            borrow = c.next;
+
+            d = _mm_add_epi32(d, ExpandSse(c.in));
+            if (!binary) {
+                d = _mm_add_epi32(d, _mm_and_si128(ExpandSse(c.out), vbase));
+            }
+            _mm_storeu_si128((__m128i *)(dst + i), d);
+        }
+        return SubScalar(dst + i, a + i, b + i, n - i, borrow, radix);
+    }
+
+    __attribute__((target("sse4.1")))
+    int CompareSse(const Limb *a, const Limb *b, size_t n) {
+        size_t i = n;
+        while (i >= 4) {
+            i -= 4;
+            __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+            __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+            unsigned diff = ~MaskSse(_mm_cmpeq_epi32(va, vb)) & 0xF;
+            if (diff) {
+                size_t lane = i + 31 - __builtin_clz(diff);
+                return a[lane] < b[lane] ? -1 : 1;
+            }
+        }
+        return CompareScalar(a, b, i);
+    }
+
+#endif  // BIG_NUM_X86_SIMD
+
+    std::vector<Kernels> Detect() {
+        std::vector<Kernels> kernels = {
+                {"scalar", AddScalar, SubScalar, CompareScalar}};
+#ifdef BIG_NUM_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse4.1")) {
+            kernels.push_back({"sse4.1", AddSse, SubSse, CompareSse});
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            kernels.push_back({"avx2", AddAvx2, SubAvx2, CompareAvx2});
+        }
+#endif
+        return kernels;
+    }
+
+}  // namespace
+
+    const std::vector<Kernels> &Supported() {
+        static const std::vector<Kernels> kernels = Detect();
+        return kernels;
+    }
+
+    const Kernels &Active() {
+        static const Kernels &kernels = Supported().back();
+        return kernels;
+    }
+
+}  // namespace simd
+
+}  // namespace big_num_arithmetic
@@ -0,0 +1,59 @@
+#ifndef SIMD_H_
+#define SIMD_H_
+
+#include <cstddef>
+#include <vector>
+#include "magnitude.h"
+
+namespace big_num_arithmetic {
+
+// Vectorized limb loops, the implementation is picked once at runtime
+// from what the CPU supports.
+namespace simd {
+
+using magnitude::Limb;
+using magnitude::Radix;
+
+// dst = a + b + carry over n limbs, returns the carry out. dst may be
+// a or b.
+using AddFunction = Limb (*)(Limb *dst, const Limb *a, const Limb *b,
+                             size_t n, Limb carry, const Radix &radix);
+// dst = a - b - borrow over n limbs, returns the borrow out. dst may
+// be a or b.
+using SubFunction = Limb (*)(Limb *dst, const Limb *a, const Limb *b,
+                             size_t n, Limb borrow, const Radix &radix);
+// Compares two n-limb numbers, returns -1, 0 or 1.
+using CompareFunction = int (*)(const Limb *a, const Limb *b, size_t n);
+
+struct Kernels {
+    const char *name;
+    AddFunction add;
+    SubFunction sub;
+    CompareFunction compare;
+};
+
+// Every implementation this CPU can run, the scalar one first.
+const std::vector<Kernels> &Supported();
+
+// The widest supported implementation.
+const Kernels &Active();
+
+inline Limb AddN(Limb *dst, const Limb *a, const Limb *b, size_t n,
+                 Limb carry, const Radix &radix) {
+    return Active().add(dst, a, b, n, carry, radix);
+}
+
+inline Limb SubN(Limb *dst, const Limb *a, const Limb *b, size_t n,
+                 Limb borrow, const Radix &radix) {
+    return Active().sub(dst, a, b, n, borrow, radix);
+}
+
+inline int CompareN(const Limb *a, const Limb *b, size_t n) {
+    return Active().compare(a, b, n);
+}
+
+}  // namespace simd
+
+}  // namespace big_num_arithmetic
+
+#endif  // SIMD_H_
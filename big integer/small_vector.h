@@ -0,0 +1,273 @@
+#ifndef SMALL_VECTOR_H_
+#define SMALL_VECTOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+namespace big_num_arithmetic {
+
+// The resource that SmallVectors constructed on this thread take their
+// heap blocks from.
+inline std::pmr::memory_resource *&CurrentMemoryResource() {
+    thread_local std::pmr::memory_resource *resource =
+            std::pmr::new_delete_resource();
+    return resource;
+}
+
+// Makes the SmallVectors, and so the BigInteger temporaries, constructed
+// on this thread while in scope allocate from resource. A monotonic
+// arena then frees a whole batch of computations at once. Numbers
+// constructed in scope must not outlive the resource. Numbers
+// constructed before keep their own resource when they are assigned to
+// or grow inside the scope, so they may hold its results.
+class ScopedMemoryResource {
+ public:
+    explicit ScopedMemoryResource(std::pmr::memory_resource *resource)
+            : previous(CurrentMemoryResource()) {
+        CurrentMemoryResource() = resource;
+    }
+
+    ~ScopedMemoryResource() {
+        CurrentMemoryResource() = previous;
+    }
+
+    ScopedMemoryResource(const ScopedMemoryResource &) = delete;
+    ScopedMemoryResource &operator=(const ScopedMemoryResource &) = delete;
+
+ private:
+    std::pmr::memory_resource *previous;
+};
+
+// A vector of trivially copyable values that keeps up to N of them
+// inline and only allocates once it grows past that.
+template<typename T, size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Elements are moved with memcpy");
+
+ public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    SmallVector() = default;
+    explicit SmallVector(size_t count, const T &value = T());
+    SmallVector(std::initializer_list<T> list);
+    template<typename It, typename = typename
+             std::iterator_traits<It>::iterator_category>
+    SmallVector(It first, It last);
+
+    SmallVector(const SmallVector &other);
+    SmallVector(SmallVector &&other) noexcept;
+    ~SmallVector();
+
+    SmallVector &operator=(const SmallVector &other);
+    SmallVector &operator=(SmallVector &&other);
+
+    size_t size() const { return len; }
+    size_t capacity() const { return cap; }
+    bool empty() const { return len == 0; }
+    // True while the values live in the inline buffer.
+    bool IsInline() const { return ptr == buffer; }
+
+    T *data() { return ptr; }
+    const T *data() const { return ptr; }
+
+    iterator begin() { return ptr; }
+    iterator end() { return ptr + len; }
+    const_iterator begin() const { return ptr; }
+    const_iterator end() const { return ptr + len; }
+
+    T &operator[](size_t i) { return ptr[i]; }
+    const T &operator[](size_t i) const { return ptr[i]; }
+
+    T &front() { return ptr[0]; }
+    const T &front() const { return ptr[0]; }
+    T &back() { return ptr[len - 1]; }
+    const T &back() const { return ptr[len - 1]; }
+
+    void push_back(const T &value);
+    void pop_back() { len--; }
+    void clear() { len = 0; }
+
+    void reserve(size_t new_cap);
+    void resize(size_t count, const T &value = T());
+
+    template<typename It>
+    iterator insert(const_iterator pos, It first, It last);
+
+    bool operator==(const SmallVector &rhs) const;
+    bool operator!=(const SmallVector &rhs) const;
+
+ private:
+    T *ptr = buffer;
+    size_t len = 0;
+    size_t cap = N;
+    // Fixed at construction, every heap block of ours comes from it.
+    std::pmr::memory_resource *resource = CurrentMemoryResource();
+    T buffer[N];
+
+    T *Allocate(size_t count);
+
+    void Release();
+};
+
+template<typename T, size_t N>
+SmallVector<T, N>::SmallVector(size_t count, const T &value) {
+    resize(count, value);
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>::SmallVector(std::initializer_list<T> list)
+        : SmallVector(list.begin(), list.end()) {}
+
+template<typename T, size_t N>
+template<typename It, typename>
+SmallVector<T, N>::SmallVector(It first, It last) {
+    insert(end(), first, last);
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>::SmallVector(const SmallVector &other) {
+    reserve(other.len);
+    std::memcpy(ptr, other.ptr, other.len * sizeof(T));
+    len = other.len;
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>::SmallVector(SmallVector &&other) noexcept {
+    // Takes over a heap block together with the resource it came from.
+    if (!other.IsInline()) {
+        resource = other.resource;
+    }
+    *this = std::move(other);
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>::~SmallVector() {
+    Release();
+}
+
+template<typename T, size_t N>
+SmallVector<T, N> &SmallVector<T, N>::operator=(const SmallVector &other) {
+    if (this != &other) {
+        len = 0;
+        reserve(other.len);
+        std::memcpy(ptr, other.ptr, other.len * sizeof(T));
+        len = other.len;
+    }
+    return *this;
+}
+
+template<typename T, size_t N>
+SmallVector<T, N> &SmallVector<T, N>::operator=(SmallVector &&other) {
+    if (this == &other) {
+        return *this;
+    }
+    if (other.IsInline()) {
+        // Keeps our own heap block, if any, for later growth.
+        std::memcpy(ptr, other.ptr, other.len * sizeof(T));
+        len = other.len;
+    } else if (*resource != *other.resource) {
+        // A block from another resource, which may go away before us.
+        *this = static_cast<const SmallVector &>(other);
+    } else {
+        Release();
+        ptr = other.ptr;
+        len = other.len;
+        cap = other.cap;
+        other.ptr = other.buffer;
+        other.cap = N;
+    }
+    other.len = 0;
+    return *this;
+}
+
+template<typename T, size_t N>
+void SmallVector<T, N>::push_back(const T &value) {
+    if (len == cap) {
+        // value may point into the storage that is about to move.
+        T copy = value;
+        reserve(2 * cap);
+        ptr[len++] = copy;
+        return;
+    }
+    ptr[len++] = value;
+}
+
+template<typename T, size_t N>
+void SmallVector<T, N>::reserve(size_t new_cap) {
+    if (new_cap <= cap) {
+        return;
+    }
+    T *block = Allocate(new_cap);
+    std::memcpy(block, ptr, len * sizeof(T));
+    Release();
+    ptr = block;
+    cap = new_cap;
+}
+
+template<typename T, size_t N>
+void SmallVector<T, N>::resize(size_t count, const T &value) {
+    if (count > len) {
+        T copy = value;
+        if (count > cap) {
+            reserve(std::max(count, 2 * cap));
+        }
+        std::fill(ptr + len, ptr + count, copy);
+    }
+    len = count;
+}
+
+template<typename T, size_t N>
+template<typename It>
+typename SmallVector<T, N>::iterator SmallVector<T, N>::insert(
+        const_iterator pos, It first, It last) {
+    size_t at = pos - ptr;
+    size_t count = std::distance(first, last);
+    if (len + count > cap) {
+        reserve(std::max(len + count, 2 * cap));
+    }
+    std::memmove(ptr + at + count, ptr + at, (len - at) * sizeof(T));
+    std::copy(first, last, ptr + at);
+    len += count;
+    return ptr + at;
+}
+
+template<typename T, size_t N>
+bool SmallVector<T, N>::operator==(const SmallVector &rhs) const {
+    return len == rhs.len && std::equal(begin(), end(), rhs.begin());
+}
+
+template<typename T, size_t N>
+bool SmallVector<T, N>::operator!=(const SmallVector &rhs) const {
+    return !(*this == rhs);
+}
+
+template<typename T, size_t N>
+T *SmallVector<T, N>::Allocate(size_t count) {
+    return static_cast<T *>(resource->allocate(count * sizeof(T),
+                                               alignof(T)));
+}
+
+template<typename T, size_t N>
+void SmallVector<T, N>::Release() {
+    if (!IsInline()) {
+        resource->deallocate(ptr, cap * sizeof(T), alignof(T));
+    }
+    ptr = buffer;
+    cap = N;
+}
+
+}  // namespace big_num_arithmetic
+
+#endif  // SMALL_VECTOR_H_
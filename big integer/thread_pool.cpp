@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <utility>
+#include "thread_pool.h"
+
+namespace big_num_arithmetic {
+
+namespace {
+
+    // Set on the threads that are running a loop body.
+    thread_local bool inside_loop = false;
+
+}  // namespace
+
+    ThreadPool::ThreadPool(size_t threads) {
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        for (size_t i = 1; i < threads; i++) {
+            workers.emplace_back([this, i] { WorkerLoop(i); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    size_t ThreadPool::Size() const {
+        return workers.size() + 1;
+    }
+
+    void ThreadPool::ParallelFor(size_t count, size_t grain,
+                                 const Body &body) {
+        grain = std::max<size_t>(grain, 1);
+        if (inside_loop || workers.empty() || count <= grain) {
+            if (count) {
+                body(0, count, 0);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> loop_lock(loop_mutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->body = &body;
+            this->count = count;
+            this->grain = grain;
+            next = 0;
+            busy = workers.size();
+            generation++;
+        }
+        wake.notify_all();
+
+        RunChunks(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return busy == 0; });
+        this->body = nullptr;
+        if (error) {
+            std::rethrow_exception(std::exchange(error, nullptr));
+        }
+    }
+
+    void ThreadPool::WorkerLoop(size_t worker) {
+        size_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stop || generation != seen; });
+                if (stop) {
+                    return;
+                }
+                seen = generation;
+            }
+
+            RunChunks(worker);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy == 0) {
+                done.notify_one();
+            }
+        }
+    }
+
+    void ThreadPool::RunChunks(size_t worker) {
+        inside_loop = true;
+        while (true) {
+            size_t begin = next.fetch_add(grain);
+            if (begin >= count) {
+                break;
+            }
+            try {
+                (*body)(begin, std::min(begin + grain, count), worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                // Skips the chunks nobody has started yet.
+                next = count;
+            }
+        }
+        inside_loop = false;
+    }
+
+    ThreadPool *&CurrentThreadPool() {
+        thread_local ThreadPool *pool = nullptr;
+        return pool;
+    }
+
+    ScopedThreadPool::ScopedThreadPool(ThreadPool *pool)
+            : previous(CurrentThreadPool()) {
+        CurrentThreadPool() = pool;
+    }
+
+    ScopedThreadPool::~ScopedThreadPool() {
+        CurrentThreadPool() = previous;
+    }
+
+}  // namespace big_num_arithmetic
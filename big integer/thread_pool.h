@@ -0,0 +1,80 @@
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace big_num_arithmetic {
+
+// A fixed set of worker threads that run one parallel loop at a time.
+class ThreadPool {
+ public:
+    // body(begin, end, worker) handles the indices [begin, end), worker
+    // is in [0, Size()) and no two concurrent calls share it.
+    using Body = std::function<void(size_t, size_t, size_t)>;
+
+    // threads == 0 picks the hardware concurrency. The calling thread
+    // takes part in every loop, so threads - 1 workers are started.
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    size_t Size() const;
+
+    // Splits [0, count) into chunks of grain indices and returns once
+    // all of them are done. The first exception thrown by a body is
+    // rethrown here. Loops started from inside a body run serially on
+    // the calling worker.
+    void ParallelFor(size_t count, size_t grain, const Body &body);
+
+ private:
+    std::vector<std::thread> workers;
+
+    // Serializes loops started from different threads.
+    std::mutex loop_mutex;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stop = false;
+    size_t generation = 0;
+    size_t busy = 0;
+
+    const Body *body = nullptr;
+    size_t count = 0;
+    size_t grain = 1;
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+
+    void WorkerLoop(size_t worker);
+    void RunChunks(size_t worker);
+};
+
+// The pool that very large multiplications and radix conversions of
+// this thread split their work across, none by default.
+ThreadPool *&CurrentThreadPool();
+
+// Makes pool the current one of this thread while in scope.
+class ScopedThreadPool {
+ public:
+    explicit ScopedThreadPool(ThreadPool *pool);
+    ~ScopedThreadPool();
+
+    ScopedThreadPool(const ScopedThreadPool &) = delete;
+    ScopedThreadPool &operator=(const ScopedThreadPool &) = delete;
+
+ private:
+    ThreadPool *previous;
+};
+
+}  // namespace big_num_arithmetic
+
+#endif  // THREAD_POOL_H_